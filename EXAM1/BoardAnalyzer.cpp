@@ -0,0 +1,50 @@
+#include "BoardAnalyzer.h"
+#include <algorithm>
+
+BoardAnalyzer::BoardAnalyzer() : scratch(1, 1, 0), solver(scratch) {}
+
+BoardDifficulty BoardAnalyzer::analyze(const Field& field) {
+    BoardDifficulty result = {0, 0, 0, false, 0};
+    scratch = field;
+    result.openings = scratch.getOpenings();
+    result.isolatedNumbers = scratch.getIsolatedNumbers();
+    result.bbbv = scratch.get3BV();
+    checkSolvable(result);
+    return result;
+}
+
+void BoardAnalyzer::analyze(const std::vector<Field>& boards, std::vector<BoardDifficulty>& results) {
+    results.clear();
+    results.reserve(boards.size());
+    for (const Field& board : boards) {
+        results.push_back(analyze(board));
+    }
+}
+
+void BoardAnalyzer::checkSolvable(BoardDifficulty& result) {
+    solver.reset();
+    for (Move move = solver.nextDeducedMove(); move.row != -1; move = solver.nextDeducedMove()) {
+        scratch.openCell(move.row, move.col);
+        solver.onCellsRevealed(scratch.getLastRevealed());
+        for (const RevealedSpan& span : scratch.getLastRevealed()) {
+            result.deducedCells += span.lastCol - span.firstCol + 1;
+        }
+        if (scratch.isExploded() || scratch.checkWin()) {
+            break;
+        }
+    }
+    result.requiresGuessing = scratch.isExploded() || !scratch.checkWin();
+}
+
+std::vector<BoardDifficulty> analyzeGeneratedBoards(int rows, int cols, int bombs, std::uint64_t firstSeed, int count) {
+    std::vector<BoardDifficulty> results;
+    results.reserve(count);
+    BoardAnalyzer analyzer;
+    Field field(rows, cols, bombs);
+    for (int board = 0; board < count; ++board) {
+        field.placeBombs(firstSeed + board, rows / 2, cols / 2);
+        field.calculateBombsNearby();
+        results.push_back(analyzer.analyze(field));
+    }
+    return results;
+}
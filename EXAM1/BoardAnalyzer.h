@@ -0,0 +1,48 @@
+#ifndef BOARDANALYZER_H
+#define BOARDANALYZER_H
+
+#include "Field.h"
+#include "Solver.h"
+#include <cstdint>
+#include <vector>
+
+struct BoardDifficulty {
+    int bbbv;             // 3BV: clicks needed without flagging
+    int openings;         // connected regions of zero cells
+    int isolatedNumbers;  // numbers not revealed by any opening
+    bool requiresGuessing;
+    int deducedCells;     // cells the solver opened before it got stuck or won
+};
+
+// Difficulty of generated boards, for filtering them before they are served.
+//
+// 3BV, openings and isolated numbers come from the board's zero-region
+// index (Field::get3BV). The guessing verdict plays a copy of the board
+// from its safe click with the solver's local rules only: the board
+// requires guessing if they get stuck before it is won. A board without a
+// safe click and with nothing open always does.
+// The scratch board, its zero-region index and its solver are copied into
+// and reset in place, so a batch of boards of one size allocates nothing
+// after the first (see the allocations/board of ./benchmark analyze).
+class BoardAnalyzer {
+private:
+    Field scratch;
+    Solver solver; // of scratch
+
+    void checkSolvable(BoardDifficulty& result);
+
+public:
+    BoardAnalyzer();
+
+    BoardAnalyzer(const BoardAnalyzer&) = delete; // the solver is bound to this scratch board
+    BoardAnalyzer& operator =(const BoardAnalyzer&) = delete;
+
+    BoardDifficulty analyze(const Field& field);
+    void analyze(const std::vector<Field>& boards, std::vector<BoardDifficulty>& results);
+};
+
+// Analyzes `count` boards generated from seeds firstSeed, firstSeed + 1, ...
+// with a safe first click in the middle, the same boards simulateGames plays.
+std::vector<BoardDifficulty> analyzeGeneratedBoards(int rows, int cols, int bombs, std::uint64_t firstSeed, int count);
+
+#endif // BOARDANALYZER_H
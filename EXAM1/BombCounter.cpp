@@ -0,0 +1,230 @@
+#include "BombCounter.h"
+#include <cstddef>
+#include <cstring>
+#include <vector>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+namespace {
+
+// padded[0] and padded[cols + 1] stay zero, padded[j + 1] is the bomb bit of column j.
+void extractBombs(const unsigned char* row, unsigned char* padded, int cols) {
+    int j = 0;
+#if defined(__AVX2__)
+    const __m256i one = _mm256_set1_epi8(Cell::BOMB);
+    for (; j + 32 <= cols; j += 32) {
+        __m256i c = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(row + j));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(padded + 1 + j), _mm256_and_si256(c, one));
+    }
+#endif
+    for (; j < cols; ++j) {
+        padded[j + 1] = row[j] & Cell::BOMB;
+    }
+}
+
+void horizontalSum(const unsigned char* padded, unsigned char* sum, int cols) {
+    int j = 0;
+#if defined(__AVX2__)
+    for (; j + 32 <= cols; j += 32) {
+        __m256i l = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(padded + j));
+        __m256i m = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(padded + j + 1));
+        __m256i r = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(padded + j + 2));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(sum + j), _mm256_add_epi8(_mm256_add_epi8(l, m), r));
+    }
+#endif
+    for (; j < cols; ++j) {
+        sum[j] = static_cast<unsigned char>(padded[j] + padded[j + 1] + padded[j + 2]);
+    }
+}
+
+void storeCounts(unsigned char* row, const unsigned char* above, const unsigned char* current,
+                 const unsigned char* below, int cols) {
+    int j = 0;
+#if defined(__AVX2__)
+    const __m256i bomb = _mm256_set1_epi8(Cell::BOMB);
+    const __m256i flags = _mm256_set1_epi8(Cell::FLAGS_MASK);
+    const __m256i countMask = _mm256_set1_epi8(static_cast<char>(~Cell::FLAGS_MASK));
+    for (; j + 32 <= cols; j += 32) {
+        __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(above + j));
+        __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(current + j));
+        __m256i c = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(below + j));
+        __m256i total = _mm256_add_epi8(_mm256_add_epi8(a, b), c);
+        __m256i nibble = _mm256_and_si256(_mm256_slli_epi16(total, Cell::COUNT_SHIFT), countMask);
+
+        __m256i cell = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(row + j));
+        __m256i updated = _mm256_or_si256(_mm256_and_si256(cell, flags), nibble);
+        __m256i isBomb = _mm256_cmpeq_epi8(_mm256_and_si256(cell, bomb), bomb);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(row + j), _mm256_blendv_epi8(updated, cell, isBomb));
+    }
+#endif
+    for (; j < cols; ++j) {
+        if (row[j] & Cell::BOMB) {
+            continue;
+        }
+        int total = above[j] + current[j] + below[j];
+        row[j] = static_cast<unsigned char>((row[j] & Cell::FLAGS_MASK) | (total << Cell::COUNT_SHIFT));
+    }
+}
+
+// Horizontal sums of one row's padded bomb plane. With wrap the padding
+// columns repeat the opposite edge, as on a torus.
+void paddedSums(unsigned char* padded, unsigned char* sum, int cols, bool wrap) {
+    if (wrap) {
+        padded[0] = padded[cols];
+        padded[cols + 1] = padded[1];
+    }
+    horizontalSum(padded, sum, cols);
+}
+
+// Horizontal sums of the row just outside a range: from a copy of its
+// bomb bits, or zero at the edge of the board.
+void outsideSums(const unsigned char* bits, unsigned char* padded, unsigned char* sum, int cols, bool wrap) {
+    if (!bits) {
+        std::memset(sum, 0, static_cast<std::size_t>(cols));
+        return;
+    }
+    std::memcpy(padded + 1, bits, static_cast<std::size_t>(cols));
+    paddedSums(padded, sum, cols, wrap);
+}
+
+// Separable 3x3 box sum over rows [firstRow, lastRow), rotating three rows
+// of horizontal sums. The rows just outside the range come from aboveBits
+// and belowBits (zero when null). With wrap the padding columns repeat the
+// opposite edge, which needs at least three columns or a cell would be
+// counted twice.
+void countRows(unsigned char* bytes, int cols, int firstRow, int lastRow, const unsigned char* aboveBits,
+               const unsigned char* belowBits, bool wrap) {
+    std::size_t width = static_cast<std::size_t>(cols);
+    std::vector<unsigned char> padded(width + 2, 0);
+    std::vector<unsigned char> sums(3 * width, 0);
+    unsigned char* above = &sums[0];
+    unsigned char* current = &sums[width];
+    unsigned char* below = &sums[2 * width];
+
+    outsideSums(aboveBits, padded.data(), above, cols, wrap);
+    extractBombs(bytes + firstRow * width, padded.data(), cols);
+    paddedSums(padded.data(), current, cols, wrap);
+
+    for (int i = firstRow; i < lastRow; ++i) {
+        if (i + 1 < lastRow) {
+            extractBombs(bytes + (i + 1) * width, padded.data(), cols);
+            paddedSums(padded.data(), below, cols, wrap);
+        }
+        else {
+            outsideSums(belowBits, padded.data(), below, cols, wrap);
+        }
+
+        storeCounts(bytes + i * width, above, current, below, cols);
+
+        unsigned char* next = above;
+        above = current;
+        current = below;
+        below = next;
+    }
+}
+
+// One neighbourhood walk per cell, for the cases the sliding sums do not cover.
+template <typename Topology>
+void countEachCell(Cell* cells, int rows, int cols) {
+    for (int row = 0; row < rows; ++row) {
+        for (int col = 0; col < cols; ++col) {
+            Cell& cell = cells[static_cast<std::size_t>(row) * cols + col];
+            if (cell.getBomb()) {
+                continue;
+            }
+            int count = 0;
+            Topology::forEachNeighbour(row, col, rows, cols, [cells, cols, &count](int r, int c) {
+                count += cells[static_cast<std::size_t>(r) * cols + c].getBomb() ? 1 : 0;
+            });
+            cell.setBombsNearby(count);
+        }
+    }
+}
+
+}
+
+// Cell is a single byte, so the board can be processed as raw bytes.
+template <>
+void countBombsNearby<SquareTopology>(Cell* cells, int rows, int cols) {
+    if (rows <= 0 || cols <= 0) {
+        return;
+    }
+    countRows(reinterpret_cast<unsigned char*>(cells), cols, 0, rows, nullptr, nullptr, false);
+}
+
+template <>
+void countBombsNearby<TorusTopology>(Cell* cells, int rows, int cols) {
+    if (rows <= 0 || cols <= 0) {
+        return;
+    }
+    if (rows < 3 || cols < 3) {
+        countEachCell<TorusTopology>(cells, rows, cols);
+        return;
+    }
+    std::vector<unsigned char> last(static_cast<std::size_t>(cols));
+    std::vector<unsigned char> first(static_cast<std::size_t>(cols));
+    copyBombBits(cells + static_cast<std::size_t>(rows - 1) * cols, cols, last.data());
+    copyBombBits(cells, cols, first.data());
+    countRows(reinterpret_cast<unsigned char*>(cells), cols, 0, rows, last.data(), first.data(), true);
+}
+
+// Odd rows sit half a cell to the right, so the rows above and below
+// contribute the pair at columns (col - 1, col) to an even row and
+// (col, col + 1) to an odd one. Three padded bomb rows are rotated and
+// every count is a branch-free sum of six bytes.
+template <>
+void countBombsNearby<HexTopology>(Cell* cells, int rows, int cols) {
+    if (rows <= 0 || cols <= 0) {
+        return;
+    }
+    unsigned char* bytes = reinterpret_cast<unsigned char*>(cells);
+    std::size_t width = static_cast<std::size_t>(cols);
+    std::size_t paddedWidth = width + 2;
+
+    std::vector<unsigned char> planes(3 * paddedWidth, 0);
+    unsigned char* above = &planes[0];
+    unsigned char* current = &planes[paddedWidth];
+    unsigned char* below = &planes[2 * paddedWidth];
+    extractBombs(bytes, current, cols);
+
+    for (int i = 0; i < rows; ++i) {
+        if (i + 1 < rows) {
+            extractBombs(bytes + (i + 1) * width, below, cols);
+        }
+        else {
+            std::memset(below, 0, paddedWidth);
+        }
+
+        unsigned char* row = bytes + i * width;
+        int shift = i & 1;
+        for (int j = 0; j < cols; ++j) {
+            if (row[j] & Cell::BOMB) {
+                continue;
+            }
+            int total = current[j] + current[j + 2] + above[j + shift] + above[j + shift + 1] + below[j + shift] +
+                        below[j + shift + 1];
+            row[j] = static_cast<unsigned char>((row[j] & Cell::FLAGS_MASK) | (total << Cell::COUNT_SHIFT));
+        }
+
+        unsigned char* next = above;
+        above = current;
+        current = below;
+        below = next;
+    }
+}
+
+void copyBombBits(const Cell* row, int cols, unsigned char* bits) {
+    for (int j = 0; j < cols; ++j) {
+        bits[j] = row[j].getBomb() ? 1 : 0;
+    }
+}
+
+void countBombsNearbyRows(Cell* cells, int cols, int firstRow, int lastRow, const unsigned char* aboveBits,
+                          const unsigned char* belowBits) {
+    if (firstRow >= lastRow || cols <= 0) {
+        return;
+    }
+    countRows(reinterpret_cast<unsigned char*>(cells), cols, firstRow, lastRow, aboveBits, belowBits, false);
+}
@@ -0,0 +1,38 @@
+#ifndef BOMBCOUNTER_H
+#define BOMBCOUNTER_H
+
+#include "Cell.h"
+#include "Topology.h"
+
+// Fills the bombs-nearby nibble of every non-bomb cell of a row-major
+// rows x cols board, with the neighbours of the given topology. Bomb cells
+// are left untouched.
+//
+// Square boards are processed as a separable 3x3 box sum: each row's bombs
+// are extracted into a zero-padded byte plane, summed horizontally once,
+// and the counts of row i are the sum of the horizontal sums of rows i-1,
+// i, i+1. A torus does the same with the padding and the rows above and
+// below wrapped around. With AVX2 enabled at compile time (-mavx2 /
+// /arch:AVX2) 32 cells are handled per instruction, otherwise a scalar loop
+// is used. Hex boards add each row's left and right neighbours to the
+// pairwise sums of the shifted rows above and below.
+template <typename Topology>
+void countBombsNearby(Cell* cells, int rows, int cols);
+
+template <>
+void countBombsNearby<SquareTopology>(Cell* cells, int rows, int cols);
+template <>
+void countBombsNearby<TorusTopology>(Cell* cells, int rows, int cols);
+template <>
+void countBombsNearby<HexTopology>(Cell* cells, int rows, int cols);
+
+// The square count for rows [firstRow, lastRow) only, so a board can be
+// counted in bands on several threads. aboveBits and belowBits hold the
+// bombs (one 0/1 byte per column) of the rows just outside the band, or
+// are null at the board's edge; working from copies lets the neighbouring
+// bands write their own rows meanwhile.
+void copyBombBits(const Cell* row, int cols, unsigned char* bits);
+void countBombsNearbyRows(Cell* cells, int cols, int firstRow, int lastRow, const unsigned char* aboveBits,
+                          const unsigned char* belowBits);
+
+#endif // BOMBCOUNTER_H
@@ -0,0 +1,91 @@
+#ifndef BOMBSAMPLING_H
+#define BOMBSAMPLING_H
+
+#include "Cell.h"
+#include "Random.h"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+
+// Bomb placement shared by Field and FixedField, so that one seed gives the
+// same board in both whatever the cells are stored in. Cells are named by
+// their row-major board index; cellAt(i) returns the Cell& at index i.
+
+// Most cells a first click keeps free: the cell and its neighbours.
+const int SAFE_ZONE_CELLS = 9;
+
+// Writes the sorted indices of the cells that may not hold a bomb when the
+// first click is (firstRow, firstCol) into excluded, and returns how many
+// there are: the cell and its neighbours, or only the cell when the rest
+// would not leave room for totalBombs. None for a click off the board.
+template <typename Topology>
+std::size_t safeZone(int rows, int cols, int firstRow, int firstCol, int totalBombs, std::size_t* excluded) {
+    if (firstRow < 0 || firstRow >= rows || firstCol < 0 || firstCol >= cols) {
+        return 0;
+    }
+    std::size_t count = 0;
+    excluded[count++] = static_cast<std::size_t>(firstRow) * cols + firstCol;
+    Topology::forEachNeighbour(firstRow, firstCol, rows, cols, [cols, excluded, &count](int row, int col) {
+        excluded[count++] = static_cast<std::size_t>(row) * cols + col;
+    });
+    std::sort(excluded, excluded + count);
+    if (static_cast<std::size_t>(rows) * cols - count < static_cast<std::size_t>(totalBombs)) {
+        excluded[0] = static_cast<std::size_t>(firstRow) * cols + firstCol;
+        count = 1;
+    }
+    return count;
+}
+
+// Floyd's sampling of `bombs` cells of [begin, end), skipping the excluded
+// ones (sorted) that fall inside. The range must hold no bombs yet. Above
+// 50% the free cells are sampled instead, so the cost is O(min(bombs,
+// free cells)). Only touches its own cells, so disjoint ranges can be
+// filled concurrently.
+template <typename CellAt>
+void sampleBombs(CellAt cellAt, std::size_t begin, std::size_t end, std::size_t bombs, const std::size_t* excluded,
+                 std::size_t excludedCount, std::uint64_t rangeSeed) {
+    std::size_t available = end - begin;
+    for (std::size_t i = 0; i < excludedCount; ++i) {
+        available -= (excluded[i] >= begin && excluded[i] < end) ? 1 : 0;
+    }
+    bool invert = bombs > available / 2;
+    std::size_t picks = invert ? available - bombs : bombs;
+
+    // Maps a position among the available cells to a board index.
+    auto boardIndex = [excluded, excludedCount, begin](std::size_t position) {
+        position += begin;
+        for (std::size_t i = 0; i < excludedCount; ++i) {
+            if (excluded[i] >= begin && position >= excluded[i]) {
+                ++position;
+            }
+        }
+        return position;
+    };
+
+    if (invert) {
+        for (std::size_t i = begin; i < end; ++i) {
+            cellAt(i).setBomb();
+        }
+        for (std::size_t i = 0; i < excludedCount; ++i) {
+            if (excluded[i] >= begin && excluded[i] < end) {
+                cellAt(excluded[i]) = Cell();
+            }
+        }
+    }
+
+    SplitMix64 random(rangeSeed);
+    for (std::size_t j = available - picks; j < available; ++j) {
+        Cell* cell = &cellAt(boardIndex(random.nextBelow(j + 1)));
+        if (cell->getBomb() != invert) {
+            cell = &cellAt(boardIndex(j));
+        }
+        if (invert) {
+            *cell = Cell();
+        }
+        else {
+            cell->setBomb();
+        }
+    }
+}
+
+#endif // BOMBSAMPLING_H
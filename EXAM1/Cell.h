@@ -1,27 +1,69 @@
 #ifndef CELL_H
 #define CELL_H
 
+// Cell is packed into a single byte so that Field can keep the whole board
+// in one contiguous row-major array:
+//   bit 0 - bomb, bit 1 - open, bit 2 - flagged, bits 4..7 - bombs nearby.
 class Cell {
 private:
-    bool hasBomb;
-    bool isOpen;
-    bool isFlagged;
-    int bombsNearby;
+    unsigned char state;
 
 public:
-    Cell();
+    static const unsigned char BOMB = 0x01;
+    static const unsigned char OPEN = 0x02;
+    static const unsigned char FLAGGED = 0x04;
+    static const unsigned char FLAGS_MASK = 0x0F;
+    static const int COUNT_SHIFT = 4;
 
-    void setBomb();
-    bool getBomb() const;
+    Cell() : state(0) {}
 
-    void setOpen();
-    bool getOpen() const;
+    void setBomb() {
+        state |= BOMB;
+    }
 
-    void setFlagged(bool flagged);
-    bool getFlagged() const;
+    void clearBomb() {
+        state &= ~BOMB;
+    }
 
-    void setBombsNearby(int bombs);
-    int getBombsNearby() const;
+    bool getBomb() const {
+        return (state & BOMB) != 0;
+    }
+
+    void setOpen() {
+        state |= OPEN;
+    }
+
+    bool getOpen() const {
+        return (state & OPEN) != 0;
+    }
+
+    void setFlagged(bool flagged) {
+        if (flagged) {
+            state |= FLAGGED;
+        }
+        else {
+            state &= ~FLAGGED;
+        }
+    }
+
+    bool getFlagged() const {
+        return (state & FLAGGED) != 0;
+    }
+
+    // Closes and unflags the cell, keeping the bomb and the count.
+    void resetPlayState() {
+        state &= ~(OPEN | FLAGGED);
+    }
+
+    void setBombsNearby(int bombs) {
+        state = static_cast<unsigned char>((state & FLAGS_MASK) | (bombs << COUNT_SHIFT));
+    }
+
+    int getBombsNearby() const {
+        return state >> COUNT_SHIFT;
+    }
 };
 
+static_assert(sizeof(Cell) == 1, "Cell must stay one byte wide");
+
 #endif // CELL_H
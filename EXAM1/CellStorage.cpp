@@ -0,0 +1,117 @@
+#include "CellStorage.h"
+#include <stdexcept>
+#include <utility>
+
+#if defined(_WIN32)
+#include <fstream>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+CellStorage::CellStorage() : cells(nullptr), count(0), mapping(nullptr), mappingSize(0) {}
+
+CellStorage::CellStorage(std::size_t size) : owned(size), cells(owned.data()), count(size), mapping(nullptr), mappingSize(0) {}
+
+CellStorage::CellStorage(const CellStorage& other)
+    : owned(other.begin(), other.end()), cells(owned.data()), count(other.count), mapping(nullptr), mappingSize(0) {}
+
+CellStorage::CellStorage(CellStorage&& other) noexcept
+    : owned(std::move(other.owned)), cells(other.cells), count(other.count), mapping(other.mapping), mappingSize(other.mappingSize) {
+    other.cells = nullptr;
+    other.count = 0;
+    other.mapping = nullptr;
+    other.mappingSize = 0;
+}
+
+CellStorage::~CellStorage() {
+    release();
+}
+
+// A heap buffer is reused when it is large enough, so copying boards of one
+// size into the same Field allocates nothing after the first copy.
+CellStorage& CellStorage::operator =(const CellStorage& other) {
+    if (this != &other) {
+        if (mapping) {
+            release();
+        }
+        owned.assign(other.begin(), other.end());
+        cells = owned.data();
+        count = other.count;
+    }
+    return *this;
+}
+
+CellStorage& CellStorage::operator =(CellStorage&& other) noexcept {
+    if (this != &other) {
+        release();
+        owned = std::move(other.owned);
+        cells = other.cells;
+        count = other.count;
+        mapping = other.mapping;
+        mappingSize = other.mappingSize;
+        other.cells = nullptr;
+        other.count = 0;
+        other.mapping = nullptr;
+        other.mappingSize = 0;
+    }
+    return *this;
+}
+
+void CellStorage::release() {
+#if !defined(_WIN32)
+    if (mapping) {
+        munmap(mapping, mappingSize);
+    }
+#endif
+    mapping = nullptr;
+    mappingSize = 0;
+    owned.clear();
+    cells = nullptr;
+    count = 0;
+}
+
+CellStorage CellStorage::mapFile(const std::string& path, std::size_t offset, std::size_t size) {
+    CellStorage storage;
+#if defined(_WIN32)
+    // No mmap here: read the cells instead.
+    std::ifstream in(path, std::ios::binary);
+    storage.owned.resize(size);
+    in.seekg(static_cast<std::streamoff>(offset));
+    if (!in.read(reinterpret_cast<char*>(storage.owned.data()), static_cast<std::streamsize>(size))) {
+        throw std::runtime_error("Cannot read snapshot cells: " + path);
+    }
+    storage.cells = storage.owned.data();
+#else
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw std::runtime_error("Cannot open snapshot: " + path);
+    }
+    std::size_t length = offset + size;
+    void* address = mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (address == MAP_FAILED) {
+        throw std::runtime_error("Cannot map snapshot: " + path);
+    }
+    storage.mapping = address;
+    storage.mappingSize = length;
+    storage.cells = reinterpret_cast<Cell*>(static_cast<char*>(address) + offset);
+#endif
+    storage.count = size;
+    return storage;
+}
+
+void CellStorage::resize(std::size_t size) {
+    if (mapping) {
+        CellStorage copy(*this);
+        *this = std::move(copy);
+    }
+    owned.resize(size);
+    cells = owned.data();
+    count = size;
+}
+
+bool CellStorage::isMapped() const {
+    return mapping != nullptr;
+}
@@ -0,0 +1,52 @@
+#ifndef CELLSTORAGE_H
+#define CELLSTORAGE_H
+
+#include "Cell.h"
+#include <cstddef>
+#include <string>
+#include <vector>
+
+// The contiguous cell array behind a Field. It is either an ordinary heap
+// buffer or a private (copy-on-write) memory mapping of a snapshot file:
+// mapping takes O(1) time, pages are read from disk the first time they
+// are touched, and writes never go back to the file. Copying always
+// produces a heap buffer.
+class CellStorage {
+private:
+    std::vector<Cell> owned;
+    Cell* cells;
+    std::size_t count;
+    void* mapping;
+    std::size_t mappingSize;
+
+    void release();
+
+public:
+    CellStorage();
+    explicit CellStorage(std::size_t size);
+    CellStorage(const CellStorage& other);
+    CellStorage(CellStorage&& other) noexcept;
+    ~CellStorage();
+
+    CellStorage& operator =(const CellStorage& other);
+    CellStorage& operator =(CellStorage&& other) noexcept;
+
+    // Maps `size` cells stored at byte `offset` of the file.
+    // Throws std::runtime_error if the file cannot be mapped.
+    static CellStorage mapFile(const std::string& path, std::size_t offset, std::size_t size);
+
+    void resize(std::size_t size);
+    bool isMapped() const;
+
+    Cell& operator [](std::size_t index) { return cells[index]; }
+    const Cell& operator [](std::size_t index) const { return cells[index]; }
+    Cell* data() { return cells; }
+    const Cell* data() const { return cells; }
+    std::size_t size() const { return count; }
+    Cell* begin() { return cells; }
+    Cell* end() { return cells + count; }
+    const Cell* begin() const { return cells; }
+    const Cell* end() const { return cells + count; }
+};
+
+#endif // CELLSTORAGE_H
@@ -0,0 +1,270 @@
+#include "ChunkedField.h"
+#include "BombCounter.h"
+#include "Field.h"
+#include "Random.h"
+#include <cmath>
+#include <iostream>
+#include <string>
+
+namespace {
+
+const int PADDED = ChunkedField::CHUNK_SIZE + 2;
+
+}
+
+ChunkedField::ChunkedField(double density, std::uint64_t worldSeed)
+    : seed(worldSeed), cachedKey({0, 0}), cachedChunk(nullptr), openedCells(0), exploded(false), revealLimit(1 << 20) {
+    int cells = CHUNK_SIZE * CHUNK_SIZE;
+    bombsPerChunk = static_cast<int>(std::lround(density * cells));
+    bombsPerChunk = bombsPerChunk < 0 ? 0 : (bombsPerChunk > cells - 9 ? cells - 9 : bombsPerChunk);
+}
+
+long long ChunkedField::chunkOf(long long coordinate) {
+    return coordinate >= 0 ? coordinate / CHUNK_SIZE : -((-coordinate + CHUNK_SIZE - 1) / CHUNK_SIZE);
+}
+
+std::size_t ChunkedField::ChunkKeyHash::operator ()(const ChunkKey& key) const {
+    return static_cast<std::size_t>(deriveSeed(static_cast<std::uint64_t>(key.row), static_cast<std::uint64_t>(key.col)));
+}
+
+ChunkedField::Chunk& ChunkedField::generatedChunk(long long chunkRow, long long chunkCol) {
+    ChunkKey key = {chunkRow, chunkCol};
+    auto found = chunks.find(key);
+    if (found != chunks.end()) {
+        return found->second;
+    }
+
+    // Each chunk is laid out like a small Field, reusing its exact-count placement.
+    std::uint64_t chunkSeed = deriveSeed(deriveSeed(seed, static_cast<std::uint64_t>(chunkRow)),
+                                         static_cast<std::uint64_t>(chunkCol));
+    Field layout(CHUNK_SIZE, CHUNK_SIZE, bombsPerChunk);
+    layout.placeBombs(chunkSeed);
+    Chunk& chunk = chunks[key];
+    chunk.cells.resize(CHUNK_SIZE * CHUNK_SIZE);
+    chunk.counted = false;
+    for (int i = 0; i < CHUNK_SIZE; ++i) {
+        for (int j = 0; j < CHUNK_SIZE; ++j) {
+            if (layout.getCell(i, j).getBomb()) {
+                chunk.cells[i * CHUNK_SIZE + j].setBomb();
+            }
+        }
+    }
+    // The safe area around the origin reaches into the chunks above and to
+    // the left. A bomb on it moves to a random free cell of the same chunk,
+    // so the count stays exact and the layout stays uniform over the cells
+    // that may hold a bomb.
+    std::vector<int> safeCells;
+    for (long long row = -1; row <= 1; ++row) {
+        for (long long col = -1; col <= 1; ++col) {
+            if (chunkOf(row) == chunkRow && chunkOf(col) == chunkCol) {
+                safeCells.push_back(static_cast<int>((row - chunkRow * CHUNK_SIZE) * CHUNK_SIZE + (col - chunkCol * CHUNK_SIZE)));
+            }
+        }
+    }
+    SplitMix64 random(deriveSeed(chunkSeed, 1));
+    for (int safe : safeCells) {
+        if (!chunk.cells[safe].getBomb()) {
+            continue;
+        }
+        chunk.cells[safe] = Cell();
+        for (;;) {
+            int target = static_cast<int>(random.nextBelow(CHUNK_SIZE * CHUNK_SIZE));
+            bool isSafe = false;
+            for (int other : safeCells) {
+                isSafe = isSafe || other == target;
+            }
+            if (!isSafe && !chunk.cells[target].getBomb()) {
+                chunk.cells[target].setBomb();
+                break;
+            }
+        }
+    }
+    return chunk;
+}
+
+// Chunks live in an unordered_map, whose elements never move, so the
+// references handed out here stay valid while new chunks are added.
+//
+// Counts need the bombs of the eight surrounding chunks: they are copied
+// into the border of a padded (CHUNK_SIZE + 2)^2 board and the regular
+// counting kernel runs over it.
+ChunkedField::Chunk& ChunkedField::countedChunk(long long chunkRow, long long chunkCol) {
+    Chunk* chunk = &generatedChunk(chunkRow, chunkCol);
+    if (chunk->counted) {
+        return *chunk;
+    }
+
+    std::vector<Cell> padded(PADDED * PADDED);
+    for (int dr = -1; dr <= 1; ++dr) {
+        for (int dc = -1; dc <= 1; ++dc) {
+            const Chunk& source = generatedChunk(chunkRow + dr, chunkCol + dc);
+            for (int i = -1; i <= CHUNK_SIZE; ++i) {
+                for (int j = -1; j <= CHUNK_SIZE; ++j) {
+                    int sourceRow = i - dr * CHUNK_SIZE;
+                    int sourceCol = j - dc * CHUNK_SIZE;
+                    if (sourceRow < 0 || sourceRow >= CHUNK_SIZE || sourceCol < 0 || sourceCol >= CHUNK_SIZE) {
+                        continue;
+                    }
+                    if (source.cells[sourceRow * CHUNK_SIZE + sourceCol].getBomb()) {
+                        padded[(i + 1) * PADDED + (j + 1)].setBomb();
+                    }
+                }
+            }
+        }
+    }
+    countBombsNearby<SquareTopology>(padded.data(), PADDED, PADDED);
+
+    for (int i = 0; i < CHUNK_SIZE; ++i) {
+        for (int j = 0; j < CHUNK_SIZE; ++j) {
+            Cell& cell = chunk->cells[i * CHUNK_SIZE + j];
+            if (!cell.getBomb()) {
+                cell.setBombsNearby(padded[(i + 1) * PADDED + (j + 1)].getBombsNearby());
+            }
+        }
+    }
+    chunk->counted = true;
+    return *chunk;
+}
+
+Cell& ChunkedField::cellAt(long long row, long long col) {
+    long long chunkRow = chunkOf(row);
+    long long chunkCol = chunkOf(col);
+    ChunkKey key = {chunkRow, chunkCol};
+    if (!cachedChunk || !(cachedKey == key)) {
+        Chunk& chunk = countedChunk(chunkRow, chunkCol);
+        cachedChunk = &chunk;
+        cachedKey = key;
+    }
+    return cachedChunk->cells[(row - chunkRow * CHUNK_SIZE) * CHUNK_SIZE + (col - chunkCol * CHUNK_SIZE)];
+}
+
+bool ChunkedField::openCell(long long row, long long col) {
+    revealed.clear();
+    Cell& cell = cellAt(row, col);
+    if (cell.getFlagged()) {
+        std::cout << "Cell is flagged. Unflag it before opening." << std::endl;
+        return false;
+    }
+    if (cell.getOpen()) {
+        std::cout << "Cell is already open." << std::endl;
+        return false;
+    }
+    if (cell.getBomb()) {
+        cell.setOpen();
+        exploded = true;
+        revealed.push_back({row, col, col});
+        return true;
+    }
+
+    expandEmptyArea(cell, row, col);
+    return true;
+}
+
+void ChunkedField::flagCell(long long row, long long col) {
+    Cell& cell = cellAt(row, col);
+    if (cell.getOpen()) {
+        std::cout << "Cannot flag an open cell." << std::endl;
+        return;
+    }
+    cell.setFlagged(!cell.getFlagged());
+}
+
+const Cell& ChunkedField::getCell(long long row, long long col) {
+    return cellAt(row, col);
+}
+
+void ChunkedField::revealOne(Cell& cell, long long row, long long col) {
+    cell.setOpen();
+    ++openedCells;
+    if (!revealed.empty() && revealed.back().row == row && revealed.back().lastCol + 1 == col) {
+        revealed.back().lastCol = col;
+    }
+    else {
+        revealed.push_back({row, col, col});
+    }
+}
+
+// Explicit-stack flood fill. A zero cell is opened only when it is popped,
+// together with every number around it; its zero neighbours are pushed
+// still closed. When revealLimit stops the flood, what is left on the stack
+// stays closed, so every open zero has its whole neighbourhood open or
+// closed zeros that a later click floods from.
+void ChunkedField::expandEmptyArea(Cell& first, long long row, long long col) {
+    std::size_t opened = 0;
+    floodStack.clear();
+    if (first.getBombsNearby() != 0) {
+        revealOne(first, row, col);
+        return;
+    }
+    floodStack.push_back(std::make_pair(row, col));
+
+    while (!floodStack.empty() && opened < revealLimit) {
+        long long r = floodStack.back().first;
+        long long c = floodStack.back().second;
+        floodStack.pop_back();
+        Cell& zero = cellAt(r, c);
+        if (zero.getOpen() || zero.getFlagged()) {
+            continue; // pushed twice, or flagged since
+        }
+        revealOne(zero, r, c);
+        ++opened;
+        for (long long nr = r - 1; nr <= r + 1; ++nr) {
+            for (long long nc = c - 1; nc <= c + 1; ++nc) {
+                Cell& cell = cellAt(nr, nc);
+                if (cell.getOpen() || cell.getFlagged() || cell.getBomb()) {
+                    continue;
+                }
+                if (cell.getBombsNearby() == 0) {
+                    floodStack.push_back(std::make_pair(nr, nc));
+                }
+                else {
+                    revealOne(cell, nr, nc);
+                    ++opened;
+                }
+            }
+        }
+    }
+}
+
+void ChunkedField::displayWindow(long long top, long long left, int rows, int cols, bool showBombs) {
+    std::string frame;
+    frame.reserve(static_cast<std::size_t>(rows) * (2 * cols + 1));
+    for (long long i = top; i < top + rows; ++i) {
+        for (long long j = left; j < left + cols; ++j) {
+            const Cell& cell = cellAt(i, j);
+            if (cell.getOpen()) {
+                frame += cell.getBomb() ? '*' : static_cast<char>('0' + cell.getBombsNearby());
+            }
+            else if (cell.getFlagged()) {
+                frame += 'F';
+            }
+            else {
+                frame += showBombs && cell.getBomb() ? '*' : '.';
+            }
+            frame += ' ';
+        }
+        frame += '\n';
+    }
+    std::cout.write(frame.data(), static_cast<std::streamsize>(frame.size()));
+    std::cout.flush();
+}
+
+void ChunkedField::setRevealLimit(std::size_t cells) {
+    revealLimit = cells;
+}
+
+const std::vector<ChunkedSpan>& ChunkedField::getLastRevealed() const {
+    return revealed;
+}
+
+bool ChunkedField::isExploded() const {
+    return exploded;
+}
+
+long long ChunkedField::getOpenedCells() const {
+    return openedCells;
+}
+
+std::size_t ChunkedField::getChunkCount() const {
+    return chunks.size();
+}
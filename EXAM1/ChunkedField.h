@@ -0,0 +1,86 @@
+#ifndef CHUNKEDFIELD_H
+#define CHUNKEDFIELD_H
+
+#include "Cell.h"
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+struct ChunkedSpan {
+    long long row;
+    long long firstCol;
+    long long lastCol;
+};
+
+// Endless board made of CHUNK_SIZE x CHUNK_SIZE chunks that are created on
+// first touch. A chunk's bombs come from deriveSeed(seed, chunk key), so the
+// world is the same whatever order it is explored in, and memory grows
+// with the explored area only. Counts are computed once the chunk and its
+// eight neighbours have their bombs, so they are consistent across chunk
+// borders. The 3x3 cells around (0, 0) never hold a bomb, and every chunk
+// holds exactly the same number of bombs, those next to the origin too.
+//
+// Rows and columns may be any 64-bit values, negative included.
+class ChunkedField {
+public:
+    static const int CHUNK_SIZE = 64;
+
+private:
+    struct Chunk {
+        std::vector<Cell> cells; // row-major, CHUNK_SIZE * CHUNK_SIZE
+        bool counted;
+    };
+
+    struct ChunkKey {
+        long long row;
+        long long col;
+
+        bool operator ==(const ChunkKey& other) const { return row == other.row && col == other.col; }
+    };
+
+    struct ChunkKeyHash {
+        std::size_t operator ()(const ChunkKey& key) const;
+    };
+
+    std::uint64_t seed;
+    int bombsPerChunk;
+    std::unordered_map<ChunkKey, Chunk, ChunkKeyHash> chunks;
+    ChunkKey cachedKey;       // last chunk looked up by cellAt
+    Chunk* cachedChunk;
+    long long openedCells;
+    bool exploded;
+    std::size_t revealLimit;
+    std::vector<ChunkedSpan> revealed;
+    std::vector<std::pair<long long, long long>> floodStack;
+
+    static long long chunkOf(long long coordinate);
+
+    Chunk& generatedChunk(long long chunkRow, long long chunkCol);
+    Chunk& countedChunk(long long chunkRow, long long chunkCol);
+    Cell& cellAt(long long row, long long col);
+    void revealOne(Cell& cell, long long row, long long col);
+    void expandEmptyArea(Cell& first, long long row, long long col);
+
+public:
+    // density: share of bomb cells, rounded to a whole number per chunk.
+    ChunkedField(double density, std::uint64_t worldSeed);
+
+    bool openCell(long long row, long long col);
+    void flagCell(long long row, long long col);
+    const Cell& getCell(long long row, long long col);
+    void displayWindow(long long top, long long left, int rows, int cols, bool showBombs);
+
+    // One click opens at most about this many cells (the numbers around the
+    // last zero opened may go a few over); a zero region that goes on
+    // further is left closed at its edge and can be opened by a later click.
+    void setRevealLimit(std::size_t cells);
+
+    const std::vector<ChunkedSpan>& getLastRevealed() const;
+    bool isExploded() const;
+    long long getOpenedCells() const;
+    std::size_t getChunkCount() const;
+};
+
+#endif // CHUNKEDFIELD_H
@@ -1,161 +1,711 @@
 #include "Field.h"
+#include "BombCounter.h"
+#include "BombSampling.h"
+#include "FieldStats.h"
+#include "Flood.h"
+#include "Journal.h"
+#include "Random.h"
+#include "Renderer.h"
+#include "Simulation.h"
+#include "Solver.h"
+#include <algorithm>
 #include <iostream>
 #include <random>
+#include <string>
 #include <chrono>
 #include <thread>
+#include <utility>
 
-Field::Field(int numRows, int numCols, int bombs) : rows(numRows), cols(numCols), totalBombs(bombs), openedCells(0) {
-    cells.resize(rows, std::vector<Cell>(cols));
+Field::Field(int numRows, int numCols, int bombs, TopologyKind kind) : rows(numRows), cols(numCols), topology(kind),
+    totalBombs(bombs), openedCells(0), seed(0), safeRow(-1), safeCol(-1), placement(PLACEMENT_SERIAL), exploded(false) {
+    cells.resize(static_cast<std::size_t>(rows) * cols);
+}
+
+Field::Field(int numRows, int numCols, int bombs, TopologyKind kind, CellStorage&& storage) : rows(numRows),
+    cols(numCols), topology(kind), cells(std::move(storage)), totalBombs(bombs), openedCells(0), seed(0), safeRow(-1),
+    safeCol(-1), placement(PLACEMENT_SERIAL), exploded(false) {
 }
 
 void Field::placeBombs() {
     std::random_device rd;
-    std::mt19937 gen(rd());
-    std::uniform_int_distribution<int> randomRow(0, rows - 1);
-    std::uniform_int_distribution<int> randomCol(0, cols - 1);
-
-    int bombsPlaced = 0;
-    while (bombsPlaced < totalBombs) {
-        int bombRow = randomRow(gen);
-        int bombCol = randomCol(gen);
-        if (!cells[bombRow][bombCol].getBomb()) {
-            cells[bombRow][bombCol].setBomb();
-            ++bombsPlaced;
+    placeBombs((static_cast<std::uint64_t>(rd()) << 32) | rd());
+}
+
+void Field::placeBombs(std::uint64_t boardSeed) {
+    placeBombs(boardSeed, -1, -1);
+}
+
+// Places exactly totalBombs bombs using Floyd's sampling, so the cost is
+// O(bombs) whatever the density (above 50% the free cells are sampled
+// instead). When (firstRow, firstCol) is given, that cell and, if there
+// is room, its neighbours are kept free of bombs.
+void Field::placeBombs(std::uint64_t boardSeed, int firstRow, int firstCol) {
+    std::fill(cells.begin(), cells.end(), Cell());
+    openedCells = 0;
+    exploded = false;
+    zeroRegions.clear();
+    seed = boardSeed;
+    safeRow = firstRow;
+    safeCol = firstCol;
+    placement = PLACEMENT_SERIAL;
+
+    std::vector<std::size_t> excluded = safeZone(firstRow, firstCol);
+    std::size_t bombs = std::min(static_cast<std::size_t>(std::max(totalBombs, 0)), cells.size() - excluded.size());
+    placeInRange(0, cells.size(), bombs, excluded, boardSeed);
+}
+
+// Sorted indices of the cells that may not hold a bomb.
+std::vector<std::size_t> Field::safeZone(int firstRow, int firstCol) const {
+    std::size_t zone[SAFE_ZONE_CELLS];
+    std::size_t count = withTopology(topology, [this, firstRow, firstCol, &zone](auto policy) {
+        return ::safeZone<decltype(policy)>(rows, cols, firstRow, firstCol, totalBombs, zone);
+    });
+    return std::vector<std::size_t>(zone, zone + count);
+}
+
+// Floyd's sampling of BombSampling.h over cells [begin, end).
+void Field::placeInRange(std::size_t begin, std::size_t end, std::size_t bombs, const std::vector<std::size_t>& excluded,
+                         std::uint64_t rangeSeed) {
+    sampleBombs([this](std::size_t i) -> Cell& { return cells[i]; }, begin, end, bombs, excluded.data(),
+                excluded.size(), rangeSeed);
+}
+
+namespace {
+
+int threadCount(int threads) {
+    return threads > 0 ? threads : std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+}
+
+// Runs work(part) for every part in [0, parts), part 0 on the calling thread.
+template <typename F>
+void runParallel(int parts, F work) {
+    std::vector<std::thread> pool;
+    for (int part = 1; part < parts; ++part) {
+        pool.emplace_back(work, part);
+    }
+    work(0);
+    for (std::thread& thread : pool) {
+        thread.join();
+    }
+}
+
+// Bomb counts of the chunks, drawn top-down over a fixed binary tree: each
+// node splits its bombs between its halves with a hypergeometric draw from
+// its own seed. A thread only walks the nodes above its own chunks, and
+// every thread draws the same split at the nodes they share.
+struct ChunkSplit {
+    std::uint64_t seed;
+    std::size_t cells;
+    const std::vector<std::size_t>* excluded;
+
+    std::size_t available(std::size_t firstChunk, std::size_t lastChunk) const {
+        std::size_t begin = firstChunk * Field::PARALLEL_CHUNK;
+        std::size_t end = std::min(cells, lastChunk * Field::PARALLEL_CHUNK);
+        std::size_t count = end - begin;
+        for (std::size_t skipped : *excluded) {
+            count -= (skipped >= begin && skipped < end) ? 1 : 0;
+        }
+        return count;
+    }
+
+    // Fills counts[chunk - wantFirst] for the chunks of [wantFirst, wantLast)
+    // under node, which covers [first, last) and holds `bombs`.
+    void split(std::uint64_t node, std::size_t first, std::size_t last, std::uint64_t bombs, std::size_t wantFirst,
+               std::size_t wantLast, std::vector<std::size_t>& counts) const {
+        if (last - first == 1) {
+            counts[first - wantFirst] = static_cast<std::size_t>(bombs);
+            return;
+        }
+        std::size_t middle = first + (last - first) / 2;
+        SplitMix64 random(deriveSeed(seed, node));
+        std::uint64_t left = sampleHypergeometric(random, available(first, last), bombs, available(first, middle));
+        if (wantFirst < middle) {
+            split(2 * node, first, middle, left, wantFirst, wantLast, counts);
+        }
+        if (wantLast > middle) {
+            split(2 * node + 1, middle, last, bombs - left, wantFirst, wantLast, counts);
+        }
+    }
+};
+
+const std::uint32_t NO_REGION = 0xFFFFFFFFu;
+
+std::uint32_t findRoot(std::vector<std::uint32_t>& parent, std::uint32_t cell) {
+    while (parent[cell] != cell) {
+        parent[cell] = parent[parent[cell]]; // path halving
+        cell = parent[cell];
+    }
+    return cell;
+}
+
+// For the phase where other threads read the same trees.
+std::uint32_t findRootReadOnly(const std::vector<std::uint32_t>& parent, std::uint32_t cell) {
+    while (parent[cell] != cell) {
+        cell = parent[cell];
+    }
+    return cell;
+}
+
+// The smaller index becomes the root, so a band's trees stay inside the band.
+void unite(std::vector<std::uint32_t>& parent, std::uint32_t a, std::uint32_t b) {
+    a = findRoot(parent, a);
+    b = findRoot(parent, b);
+    if (a < b) {
+        parent[b] = a;
+    }
+    else if (b < a) {
+        parent[a] = b;
+    }
+}
+
+}
+
+void Field::placeBombsParallel(std::uint64_t boardSeed, int firstRow, int firstCol, int threads) {
+    openedCells = 0;
+    exploded = false;
+    zeroRegions.clear();
+    seed = boardSeed;
+    safeRow = firstRow;
+    safeCol = firstCol;
+    placement = PLACEMENT_PARALLEL;
+
+    std::vector<std::size_t> excluded = safeZone(firstRow, firstCol);
+    std::size_t bombs = std::min(static_cast<std::size_t>(std::max(totalBombs, 0)), cells.size() - excluded.size());
+    std::size_t chunks = (cells.size() + PARALLEL_CHUNK - 1) / PARALLEL_CHUNK;
+    if (chunks == 0) {
+        return;
+    }
+    int parts = static_cast<int>(std::min<std::size_t>(threadCount(threads), chunks));
+    ChunkSplit splitter = {deriveSeed(boardSeed, 0), cells.size(), &excluded};
+    std::uint64_t chunkSeeds = deriveSeed(boardSeed, 1);
+
+    runParallel(parts, [this, chunks, parts, bombs, chunkSeeds, &splitter, &excluded](int part) {
+        std::size_t first = chunks * part / parts;
+        std::size_t last = chunks * (part + 1) / parts;
+        std::vector<std::size_t> counts(last - first);
+        splitter.split(1, 0, chunks, bombs, first, last, counts);
+        for (std::size_t chunk = first; chunk < last; ++chunk) {
+            std::size_t begin = chunk * PARALLEL_CHUNK;
+            std::size_t end = std::min(cells.size(), begin + PARALLEL_CHUNK);
+            std::fill(cells.begin() + begin, cells.begin() + end, Cell());
+            placeInRange(begin, end, counts[chunk - first], excluded, deriveSeed(chunkSeeds, chunk));
+        }
+    });
+}
+
+// The halo rows are copied before any band starts writing, so a band never
+// reads a byte another band writes.
+void Field::calculateBombsNearbyParallel(int threads) {
+    if (topology != TOPOLOGY_SQUARE || rows <= 0 || cols <= 0) {
+        calculateBombsNearby();
+        return;
+    }
+    int bands = std::min(threadCount(threads), rows);
+    std::size_t width = static_cast<std::size_t>(cols);
+    std::vector<unsigned char> halo(2 * bands * width);
+    for (int band = 0; band < bands; ++band) {
+        int first = static_cast<int>(static_cast<long long>(rows) * band / bands);
+        int last = static_cast<int>(static_cast<long long>(rows) * (band + 1) / bands);
+        if (first > 0) {
+            copyBombBits(&cells[index(first - 1, 0)], cols, &halo[2 * band * width]);
+        }
+        if (last < rows) {
+            copyBombBits(&cells[index(last, 0)], cols, &halo[(2 * band + 1) * width]);
         }
     }
+
+    runParallel(bands, [this, bands, width, &halo](int band) {
+        int first = static_cast<int>(static_cast<long long>(rows) * band / bands);
+        int last = static_cast<int>(static_cast<long long>(rows) * (band + 1) / bands);
+        countBombsNearbyRows(cells.data(), cols, first, last, first > 0 ? &halo[2 * band * width] : nullptr,
+                             last < rows ? &halo[(2 * band + 1) * width] : nullptr);
+    });
+    zeroRegions.clear();
 }
 
 void Field::calculateBombsNearby() {
-    for (int i = 0; i < rows; ++i) {
-        for (int j = 0; j < cols; ++j) {
-            if (cells[i][j].getBomb()) {
-                continue;
+    withTopology(topology, [this](auto policy) {
+        countBombsNearby<decltype(policy)>(cells.data(), rows, cols);
+    });
+    zeroRegions.clear();
+}
+
+// Only the 3x3 neighbourhoods of the two cells change, so the counts are
+// patched there instead of recounting the board.
+bool Field::moveBomb(int fromRow, int fromCol, int toRow, int toCol) {
+    Cell& from = cells[index(fromRow, fromCol)];
+    Cell& to = cells[index(toRow, toCol)];
+    if (!from.getBomb() || from.getOpen() || to.getBomb() || to.getOpen()) {
+        return false;
+    }
+
+    int fromCount = 0;
+    withTopology(topology, [&](auto policy) {
+        typedef decltype(policy) Topology;
+        Topology::forEachNeighbour(fromRow, fromCol, rows, cols, [this, &fromCount](int row, int col) {
+            Cell& cell = cells[index(row, col)];
+            if (cell.getBomb()) {
+                ++fromCount;
             }
-            int bombsNearby = 0;
-            for (int row = std::max(0, i - 1); row <= std::min(rows - 1, i + 1); ++row) {
-                for (int col = std::max(0, j - 1); col <= std::min(cols - 1, j + 1); ++col) {
-                    if (cells[row][col].getBomb()) {
-                        ++bombsNearby;
-                    }
-                }
+            else {
+                cell.setBombsNearby(cell.getBombsNearby() - 1);
             }
-            cells[i][j].setBombsNearby(bombsNearby);
-        }
+        });
+        from.clearBomb();
+        from.setBombsNearby(fromCount);
+
+        to.setBomb();
+        to.setBombsNearby(0);
+        Topology::forEachNeighbour(toRow, toCol, rows, cols, [this](int row, int col) {
+            Cell& cell = cells[index(row, col)];
+            if (!cell.getBomb()) {
+                cell.setBombsNearby(cell.getBombsNearby() + 1);
+            }
+        });
+    });
+    zeroRegions.clear();
+    return true;
+}
+
+void Field::resetPlay() {
+    for (Cell& cell : cells) {
+        cell.resetPlayState();
     }
+    openedCells = 0;
+    exploded = false;
+    revealed.clear();
+    zeroRegions.clear();
 }
 
 bool Field::openCell(int row, int col) {
-    if (cells[row][col].getFlagged()) {
+    FIELD_STATS_OPEN_SCOPE();
+    revealed.clear();
+    Cell& cell = cells[index(row, col)];
+    if (cell.getFlagged()) {
         std::cout << "Cell is flagged. Unflag it before opening." << std::endl;
         return false;
     }
-    if (cells[row][col].getOpen()) {
+    if (cell.getOpen()) {
         std::cout << "Cell is already open." << std::endl;
         return false;
     }
-    if (cells[row][col].getBomb()) {
-        cells[row][col].setOpen();
+    if (recorder.journal) {
+        recorder.journal->record(JOURNAL_OPEN, row, col);
+    }
+    if (cell.getBomb()) {
+        cell.setOpen();
+        exploded = true;
+        revealed.push_back({row, col, col});
         return true;
     }
 
-    expandEmptyArea(row, col);
+    if (!revealZeroRegion(row, col)) {
+        floodStack.clear();
+        addFloodSeed(row, col);
+        runFlood();
+    }
     return true;
 }
 
-void Field::flagCell(int row, int col) {
-    if (cells[row][col].getOpen()) {
-        std::cout << "Cannot flag an open cell." << std::endl;
+void Field::openSeed(int row, int col, OpenStatus& status) {
+    if (row < 0 || row >= rows || col < 0 || col >= cols) {
+        ++status.skipped;
+        return;
+    }
+    Cell& cell = cells[index(row, col)];
+    if (cell.getFlagged() || cell.getOpen()) {
+        ++status.skipped;
+        return;
+    }
+    if (recorder.journal) {
+        recorder.journal->record(JOURNAL_OPEN, row, col);
+    }
+    if (cell.getBomb()) {
+        cell.setOpen();
+        exploded = true;
+        revealed.push_back({row, col, col});
+        if (!status.exploded) {
+            status.exploded = true;
+            status.bombRow = row;
+            status.bombCol = col;
+        }
         return;
     }
-    cells[row][col].setFlagged(!cells[row][col].getFlagged());
+    if (!revealZeroRegion(row, col)) {
+        addFloodSeed(row, col);
+    }
 }
 
-bool Field::checkWin() const {
-    return openedCells == (rows * cols - totalBombs);
+// Seeds are only queued; the one flood at the end expands all of them.
+OpenStatus Field::openCells(const std::pair<int, int>* coords, std::size_t count) {
+    FIELD_STATS_OPEN_SCOPE();
+    OpenStatus status = {0, 0, false, -1, -1, false};
+    revealed.clear();
+    floodStack.clear();
+    long long openedBefore = openedCells;
+    for (std::size_t i = 0; i < count; ++i) {
+        openSeed(coords[i].first, coords[i].second, status);
+    }
+    runFlood();
+    status.opened = openedCells - openedBefore;
+    return status;
 }
 
-void Field::displayField(bool showBombs) const {
-    for (int i = 0; i < rows; ++i) {
-        for (int j = 0; j < cols; ++j) {
-            if (cells[i][j].getOpen()) {
-                if (cells[i][j].getBomb()) {
-                    std::cout << "* ";
+OpenStatus Field::openCells(const std::vector<std::pair<int, int>>& coords) {
+    return openCells(coords.data(), coords.size());
+}
+
+// Four passes, with a join between each:
+//   1. (bands) union-find over the floodable cells of each band, linking
+//      every cell to its floodable neighbours left of and above it
+//   2. (serial) the same links across each band's top border
+//   3. (bands) mark the cells whose root is the click's root
+//   4. (bands) open the marked cells and every closed number next to one,
+//      collecting each band's revealed spans
+// Each pass writes only its own band's cells, labels and marks.
+OpenStatus Field::openCellParallel(int row, int col, int threads) {
+    std::size_t size = cells.size();
+    if (topology != TOPOLOGY_SQUARE || zeroRegions.isBuilt() || size >= NO_REGION || row < 0 || row >= rows ||
+        col < 0 || col >= cols || !isFloodable(row, col)) {
+        std::pair<int, int> cell(row, col);
+        return openCells(&cell, 1);
+    }
+
+    FIELD_STATS_OPEN_SCOPE();
+    OpenStatus status = {0, 0, false, -1, -1, false};
+    revealed.clear();
+    if (recorder.journal) {
+        recorder.journal->record(JOURNAL_OPEN, row, col);
+    }
+
+    int bands = std::min(threadCount(threads), rows);
+    std::vector<int> bandStart(bands + 1);
+    for (int band = 0; band <= bands; ++band) {
+        bandStart[band] = static_cast<int>(static_cast<long long>(rows) * band / bands);
+    }
+    // Every entry of parent and inRegion is written below before it is read.
+    std::vector<std::uint32_t>& parent = parallelScratch.parent;
+    std::vector<unsigned char>& inRegion = parallelScratch.inRegion;
+    std::vector<std::vector<RevealedSpan>>& bandSpans = parallelScratch.bandSpans;
+    parent.resize(size);
+    inRegion.resize(size);
+    bandSpans.resize(bands);
+    for (std::vector<RevealedSpan>& spans : bandSpans) {
+        spans.clear();
+    }
+    std::vector<long long> bandOpened(bands, 0);
+
+    runParallel(bands, [this, &bandStart, &parent](int band) {
+        for (int r = bandStart[band]; r < bandStart[band + 1]; ++r) {
+            for (int c = 0; c < cols; ++c) {
+                std::uint32_t cell = static_cast<std::uint32_t>(index(r, c));
+                if (!isFloodable(r, c)) {
+                    parent[cell] = NO_REGION;
+                    continue;
                 }
-                else {
-                    std::cout << cells[i][j].getBombsNearby() << " ";
+                parent[cell] = cell;
+                if (c > 0 && isFloodable(r, c - 1)) {
+                    unite(parent, cell, cell - 1);
+                }
+                if (r == bandStart[band]) {
+                    continue;
+                }
+                for (int nc = std::max(0, c - 1); nc <= std::min(cols - 1, c + 1); ++nc) {
+                    if (isFloodable(r - 1, nc)) {
+                        unite(parent, cell, static_cast<std::uint32_t>(index(r - 1, nc)));
+                    }
                 }
             }
-            else {
-                if (cells[i][j].getFlagged()) {
-                    std::cout << "F ";
+        }
+    });
+
+    for (int band = 1; band < bands; ++band) {
+        int r = bandStart[band];
+        for (int c = 0; c < cols; ++c) {
+            std::uint32_t cell = static_cast<std::uint32_t>(index(r, c));
+            if (parent[cell] == NO_REGION) {
+                continue;
+            }
+            for (int nc = std::max(0, c - 1); nc <= std::min(cols - 1, c + 1); ++nc) {
+                std::uint32_t above = static_cast<std::uint32_t>(index(r - 1, nc));
+                if (parent[above] != NO_REGION) {
+                    unite(parent, cell, above);
                 }
-                else if (showBombs && cells[i][j].getBomb()) {
-                    std::cout << "* ";
+            }
+        }
+    }
+    std::uint32_t target = findRoot(parent, static_cast<std::uint32_t>(index(row, col)));
+
+    runParallel(bands, [this, target, &bandStart, &parent, &inRegion](int band) {
+        std::size_t first = index(bandStart[band], 0);
+        std::size_t last = index(bandStart[band + 1], 0);
+        for (std::size_t cell = first; cell < last; ++cell) {
+            inRegion[cell] = parent[cell] != NO_REGION && findRootReadOnly(parent, static_cast<std::uint32_t>(cell)) == target;
+        }
+    });
+
+    runParallel(bands, [this, &bandStart, &inRegion, &bandSpans, &bandOpened](int band) {
+        std::vector<RevealedSpan>& spans = bandSpans[band];
+        for (int r = bandStart[band]; r < bandStart[band + 1]; ++r) {
+            for (int c = 0; c < cols; ++c) {
+                Cell& cell = cells[index(r, c)];
+                bool open = inRegion[index(r, c)] != 0;
+                if (!open && !cell.getOpen() && !cell.getFlagged() && !cell.getBomb()) {
+                    for (int nr = std::max(0, r - 1); nr <= std::min(rows - 1, r + 1) && !open; ++nr) {
+                        for (int nc = std::max(0, c - 1); nc <= std::min(cols - 1, c + 1) && !open; ++nc) {
+                            open = inRegion[index(nr, nc)] != 0;
+                        }
+                    }
+                }
+                if (!open) {
+                    continue;
+                }
+                cell.setOpen();
+                ++bandOpened[band];
+                if (!spans.empty() && spans.back().row == r && spans.back().lastCol + 1 == c) {
+                    spans.back().lastCol = c;
                 }
                 else {
-                    std::cout << ". ";
+                    spans.push_back({r, c, c});
                 }
             }
         }
-        std::cout << std::endl;
+    });
+
+    for (int band = 0; band < bands; ++band) {
+        revealed.insert(revealed.end(), bandSpans[band].begin(), bandSpans[band].end());
+        status.opened += bandOpened[band];
     }
+    openedCells += status.opened;
+    FIELD_STATS_ADD(cellsOpened, status.opened);
+    return status;
 }
 
-void Field::expandEmptyArea(int row, int col) {
-    if (row < 0 || row >= rows || col < 0 || col >= cols || cells[row][col].getOpen() || cells[row][col].getBomb()) {
-        return;
+OpenStatus Field::chord(int row, int col) {
+    FIELD_STATS_OPEN_SCOPE();
+    OpenStatus status = {0, 0, false, -1, -1, false};
+    revealed.clear();
+    floodStack.clear();
+    if (row < 0 || row >= rows || col < 0 || col >= cols) {
+        status.refused = true;
+        return status;
+    }
+    const Cell& centre = cells[index(row, col)];
+    if (!centre.getOpen() || centre.getBomb() || centre.getBombsNearby() == 0) {
+        status.refused = true;
+        return status;
     }
 
-    cells[row][col].setOpen();
-    ++openedCells;
-
-    if (cells[row][col].getBombsNearby() == 0) {
-        for (int i = -1; i <= 1; ++i) {
-            for (int j = -1; j <= 1; ++j) {
-                if (i != 0 || j != 0) {
-                    expandEmptyArea(row + i, col + j);
-                }
-            }
+    long long openedBefore = openedCells;
+    withTopology(topology, [this, row, col, &centre, &status](auto policy) {
+        typedef decltype(policy) Topology;
+        int flags = 0;
+        Topology::forEachNeighbour(row, col, rows, cols, [this, &flags](int r, int c) {
+            flags += cells[index(r, c)].getFlagged() ? 1 : 0;
+        });
+        if (flags != centre.getBombsNearby()) {
+            status.refused = true;
+            return;
         }
+        Topology::forEachNeighbour(row, col, rows, cols, [this, &status](int r, int c) {
+            const Cell& cell = cells[index(r, c)];
+            if (!cell.getOpen() && !cell.getFlagged()) {
+                openSeed(r, c, status);
+            }
+        });
+    });
+    if (status.refused) {
+        return status;
     }
+    runFlood();
+    status.opened = openedCells - openedBefore;
+    return status;
 }
 
-std::pair<int, int> Field::autoplaySelectCell() {
-    for (int i = 0; i < rows; ++i) {
-        for (int j = 0; j < cols; ++j) {
-            if (!cells[i][j].getOpen()) {
-                return std::make_pair(i, j);
-            }
-        }
+void Field::flagCell(int row, int col) {
+    Cell& cell = cells[index(row, col)];
+    if (cell.getOpen()) {
+        std::cout << "Cannot flag an open cell." << std::endl;
+        return;
+    }
+    cell.setFlagged(!cell.getFlagged());
+    if (recorder.journal) {
+        recorder.journal->record(JOURNAL_FLAG, row, col);
+    }
+    if (zeroRegions.isBuilt() && !cell.getBomb()) {
+        zeroRegions.flagChanged(rows, cols, index(row, col), cell.getFlagged());
     }
-    return std::make_pair(-1, -1);
 }
 
-void Field::autoplay() {
-    std::pair<int, int> selectedCell = autoplaySelectCell();
+void Field::setJournal(MoveJournal* journal) {
+    recorder.journal = journal;
+    if (journal) {
+        journal->begin(*this);
+    }
+}
 
-    while (selectedCell.first != -1 && selectedCell.second != -1) {
-        std::this_thread::sleep_for(std::chrono::milliseconds(500));
+bool Field::checkWin() const {
+    return openedCells == static_cast<long long>(rows) * cols - totalBombs;
+}
+
+void Field::displayField(bool showBombs) const {
+    display.text.clear();
+    renderField(*this, showBombs, display.text);
+    std::cout.write(display.text.data(), static_cast<std::streamsize>(display.text.size()));
+    std::cout.flush();
+}
+
+const std::vector<RevealedSpan>& Field::getLastRevealed() const {
+    return revealed;
+}
+
+std::uint64_t Field::getSeed() const {
+    return seed;
+}
 
-        std::cout << "Auto-playing cell (" << selectedCell.first << ", " << selectedCell.second << ")... ";
+std::pair<int, int> Field::getSafeCell() const {
+    return std::make_pair(safeRow, safeCol);
+}
+
+bool Field::isExploded() const {
+    return exploded;
+}
+
+bool Field::indexZeroRegions() {
+    return zeroRegions.build(cells.data(), rows, cols, topology);
+}
+
+int Field::getOpenings() {
+    if (!zeroRegions.isBuilt() && !indexZeroRegions()) {
+        return -1;
+    }
+    return zeroRegions.getOpenings();
+}
 
-        bool gameOver = !openCell(selectedCell.first, selectedCell.second);
+int Field::get3BV() {
+    if (!zeroRegions.isBuilt() && !indexZeroRegions()) {
+        return -1;
+    }
+    return zeroRegions.get3BV();
+}
 
-        if (gameOver) {
-            std::cout << "Game over!" << std::endl;
-            break;
+int Field::getIsolatedNumbers() {
+    if (!zeroRegions.isBuilt() && !indexZeroRegions()) {
+        return -1;
+    }
+    return zeroRegions.getIsolatedNumbers();
+}
+
+// Bulk reveal through the zero-region index. Returns false when the flood
+// fill has to run instead: no index, not a zero cell, or a flag in the way.
+bool Field::revealZeroRegion(int row, int col) {
+    if (!zeroRegions.isBuilt()) {
+        return false;
+    }
+    int region = zeroRegions.regionOfCell(index(row, col));
+    if (region < 0 || zeroRegions.isBlocked(region)) {
+        return false;
+    }
+    FIELD_STATS_ADD(cellsVisited, zeroRegions.regionEnd(region) - zeroRegions.regionBegin(region));
+    for (const std::uint32_t* member = zeroRegions.regionBegin(region); member != zeroRegions.regionEnd(region); ++member) {
+        if (!cells[*member].getOpen()) {
+            revealOne(static_cast<int>(*member / cols), static_cast<int>(*member % cols));
         }
+    }
+    return true;
+}
+
+// A closed, unflagged cell with no bombs around: the flood continues through it.
+bool Field::isFloodable(int row, int col) const {
+    const Cell& cell = cells[index(row, col)];
+    return !cell.getOpen() && !cell.getFlagged() && !cell.getBomb() && cell.getBombsNearby() == 0;
+}
+
+void Field::revealOne(int row, int col) {
+    cells[index(row, col)].setOpen();
+    ++openedCells;
+    FIELD_STATS_ADD(cellsOpened, 1);
+    if (!revealed.empty() && revealed.back().row == row && revealed.back().lastCol + 1 == col) {
+        revealed.back().lastCol = col;
+    }
+    else {
+        revealed.push_back({row, col, col});
+    }
+}
 
-        displayField(false);
-        std::cout << std::endl;
+// Queues a cell for runFlood, or opens it right away if it is a number.
+void Field::addFloodSeed(int row, int col) {
+    FIELD_STATS_ADD(cellsVisited, 1);
+    if (isFloodable(row, col)) {
+        floodStack.push_back(std::make_pair(row, col));
+        return;
+    }
+    const Cell& cell = cells[index(row, col)];
+    if (!cell.getOpen() && !cell.getFlagged() && !cell.getBomb()) {
+        revealOne(row, col);
+    }
+}
 
-        if (checkWin()) {
-            std::cout << "Congratulations! You've won the game!" << std::endl;
-            break;
+// Expands every queued seed with the shared floods of Flood.h: scanline
+// runs on square boards; runs do not wrap or shift, so the other
+// topologies go cell by cell.
+void Field::runFlood() {
+    auto floodable = [this](int row, int col) {
+        return isFloodable(row, col);
+    };
+    auto open = [this](int row, int col) {
+        const Cell& cell = cells[index(row, col)];
+        if (!cell.getOpen() && !cell.getFlagged() && !cell.getBomb()) {
+            revealOne(row, col);
         }
+    };
+    if (topology == TOPOLOGY_SQUARE) {
+        scanlineFlood(rows, cols, floodStack, floodable, open);
+        return;
+    }
+    withTopology(topology, [this, &floodable, &open](auto policy) {
+        neighbourFlood<decltype(policy)>(rows, cols, floodStack, floodable, open);
+    });
+}
 
-        selectedCell = autoplaySelectCell();
+// One-off pick that builds a solver from the current board. autoplay keeps
+// a single Solver alive instead, so each move only re-examines what changed.
+std::pair<int, int> Field::autoplaySelectCell() {
+    Solver solver(*this);
+    Move move = solver.nextMove();
+    return std::make_pair(move.row, move.col);
+}
+
+namespace {
+
+// Console front-end for autoplay: shows every move at a watchable pace.
+// The board is drawn once and then only the cells a move changed (opened
+// or flagged by the solver) are repainted; the line under it says which
+// cell was played.
+class ConsoleObserver : public GameObserver {
+private:
+    FieldRenderer renderer;
+
+public:
+    void onMove(const Field& field, const Move& move) override {
+        std::this_thread::sleep_for(std::chrono::milliseconds(500));
+        renderer.drawUpdate(field, field.isExploded());
+        std::cout << "\x1b[KAuto-playing cell (" << move.row << ", " << move.col << ")" << (move.guess ? " [guess]" : "")
+                  << std::endl;
     }
+};
 
+}
+
+void Field::autoplay() {
+    ConsoleObserver observer;
+    GameResult result = playGame(*this, &observer);
+
+    if (result.won) {
+        std::cout << "Congratulations! You've won the game!" << std::endl;
+    }
+    else if (isExploded()) {
+        std::cout << "Game over!" << std::endl;
+    }
     std::cout << "Autoplay finished." << std::endl;
 }
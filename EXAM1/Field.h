@@ -2,29 +2,191 @@
 #define FIELD_H
 
 #include "Cell.h"
+#include "CellStorage.h"
+#include "Topology.h"
+#include "ZeroRegionIndex.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
 #include <vector>
 #include <utility>
 
+// A run of cells in one row opened by the same openCell call.
+struct RevealedSpan {
+    int row;
+    int firstCol;
+    int lastCol;
+};
+
+// A view of revealed spans, such as FixedField::getLastRevealed: valid
+// until the board's next openCell.
+struct RevealedRange {
+    const RevealedSpan* first;
+    const RevealedSpan* last;
+
+    const RevealedSpan* begin() const { return first; }
+    const RevealedSpan* end() const { return last; }
+    std::size_t size() const { return static_cast<std::size_t>(last - first); }
+    bool empty() const { return first == last; }
+};
+
+// What openCells or chord did. Nothing is printed; skipped seeds are
+// simply counted.
+struct OpenStatus {
+    long long opened; // safe cells opened, flood included
+    int skipped;   // seeds off the board, flagged or already open when reached
+    bool exploded; // a seed was a bomb (it is opened, the rest still are too)
+    int bombRow;   // the first bomb hit, or -1
+    int bombCol;
+    bool refused;  // chord on a cell that is not an open number with exactly that many flags around
+};
+
+// Which generator placed the bombs; the two give different layouts for one seed.
+enum BombPlacement : unsigned char { PLACEMENT_SERIAL, PLACEMENT_PARALLEL };
+
+class MoveJournal;
+
 class Field {
 private:
+    // A copy of a recorded game is a different game, so copies start unrecorded.
+    struct JournalLink {
+        MoveJournal* journal = nullptr;
+        JournalLink() = default;
+        JournalLink(const JournalLink&) {}
+        JournalLink& operator =(const JournalLink&) { return *this; }
+    };
+
+    // displayField's text, reused from frame to frame; copies start empty.
+    struct FrameBuffer {
+        std::string text;
+        FrameBuffer() = default;
+        FrameBuffer(const FrameBuffer&) {}
+        FrameBuffer& operator =(const FrameBuffer&) { return *this; }
+    };
+
+    // openCellParallel's labels and region marks (5 bytes a cell) and its
+    // per-band spans, kept for the next call; copies start empty.
+    struct ParallelScratch {
+        std::vector<std::uint32_t> parent;
+        std::vector<unsigned char> inRegion;
+        std::vector<std::vector<RevealedSpan>> bandSpans;
+        ParallelScratch() = default;
+        ParallelScratch(const ParallelScratch&) {}
+        ParallelScratch& operator =(const ParallelScratch&) { return *this; }
+    };
+
     int rows;
     int cols;
-    std::vector<std::vector<Cell>> cells;
+    TopologyKind topology; // which cells are neighbours; fixed for the life of the board
+    CellStorage cells; // row-major, rows * cols
     int totalBombs;
-    int openedCells;
+    long long openedCells; // a board may hold 2^31 cells or more
+    std::uint64_t seed; // seed and safe click the bombs were placed with
+    int safeRow;
+    int safeCol;
+    BombPlacement placement;
+    bool exploded;
+
+    std::vector<RevealedSpan> revealed;          // cells opened by the last openCell, openCells or chord
+    std::vector<std::pair<int, int>> floodStack; // pending flood runs, reused between calls
+    ZeroRegionIndex zeroRegions;                 // built on demand, dropped when the layout changes
+    JournalLink recorder;                        // receives every openCell/flagCell that changes the board
+    mutable FrameBuffer display;
+    ParallelScratch parallelScratch;
+
+    std::size_t index(int row, int col) const {
+        return static_cast<std::size_t>(row) * cols + col;
+    }
+
+    std::vector<std::size_t> safeZone(int firstRow, int firstCol) const;
+    void placeInRange(std::size_t begin, std::size_t end, std::size_t bombs, const std::vector<std::size_t>& excluded,
+                      std::uint64_t rangeSeed);
+    bool isFloodable(int row, int col) const;
+    void revealOne(int row, int col);
+    void addFloodSeed(int row, int col);
+    void runFlood();
+    bool revealZeroRegion(int row, int col);
+    void openSeed(int row, int col, OpenStatus& status);
+
+    Field(int numRows, int numCols, int bombs, TopologyKind kind, CellStorage&& storage);
 
-    void expandEmptyArea(int row, int col);
+    friend class Snapshot;
+    friend class SnapshotWriter;
 
 public:
-    Field(int numRows, int numCols, int bombs);
+    // Cells per chunk of placeBombsParallel. Fixed, so a seed gives the same
+    // board whatever the number of threads.
+    static const std::size_t PARALLEL_CHUNK = 1 << 16;
+
+    Field(int numRows, int numCols, int bombs, TopologyKind kind = TOPOLOGY_SQUARE);
 
     void placeBombs();
+    void placeBombs(std::uint64_t boardSeed);
+    void placeBombs(std::uint64_t boardSeed, int firstRow, int firstCol);
     void calculateBombsNearby();
+    // Multi-threaded versions for very large boards; threads <= 0 uses every
+    // core. placeBombsParallel splits the exact bomb count between chunks
+    // of PARALLEL_CHUNK cells (hypergeometric draws down a binary tree) and
+    // fills every chunk from its own seed stream, so every layout is still
+    // equally likely, but it is not the layout placeBombs gives for the
+    // same seed. calculateBombsNearbyParallel counts bands of rows against
+    // copies of their halo rows; other topologies than square count on one
+    // thread.
+    void placeBombsParallel(std::uint64_t boardSeed, int firstRow, int firstCol, int threads = 0);
+    void calculateBombsNearbyParallel(int threads = 0);
+    // Moves a bomb to a closed bomb-free cell and updates the counts around
+    // both cells. Returns false if either cell does not qualify.
+    bool moveBomb(int fromRow, int fromCol, int toRow, int toCol);
+    // Closes and unflags every cell, keeping the layout, seed and safe cell.
+    void resetPlay();
     bool openCell(int row, int col);
+    // Open every listed cell. Zero cells among them are flooded together in
+    // one pass, so cells shared by several of their regions are visited once.
+    OpenStatus openCells(const std::pair<int, int>* coords, std::size_t count);
+    OpenStatus openCells(const std::vector<std::pair<int, int>>& coords);
+    // openCells for one cell, for a first click into a huge zero region:
+    // bands of rows label their zero cells with union-find on separate
+    // threads, the labels are merged across band borders, and the bands
+    // then open the click's region and its border in parallel. It labels
+    // the whole board, so it only pays off when the region is large; its
+    // buffers stay allocated for the next click on the board. Falls
+    // back to openCells for a non-zero cell, a built zero-region index,
+    // other topologies than square, or boards of 2^32 cells or more.
+    OpenStatus openCellParallel(int row, int col, int threads = 0);
+    // Opens the closed unflagged neighbours of an open number whose flag
+    // count matches it, as one openCells batch.
+    OpenStatus chord(int row, int col);
     void flagCell(int row, int col);
     bool checkWin() const;
     void displayField(bool showBombs) const;
 
+    const std::vector<RevealedSpan>& getLastRevealed() const;
+
+    // Labels the zero regions of the counted board. From then on opening a
+    // zero cell reveals its precomputed region in one pass (unless a flag
+    // blocks it). placeBombs, calculateBombsNearby and moveBomb discard the
+    // index. Returns false for boards of 2^32 cells or more, which keep
+    // flooding.
+    bool indexZeroRegions();
+    // Records every later openCell/flagCell that changes the board into
+    // journal, starting it with this board's size, topology, seed, safe
+    // click and placement. Pass nullptr to stop recording.
+    void setJournal(MoveJournal* journal);
+
+    int getOpenings();  // these build the index if needed; -1 if it cannot be built
+    int get3BV();
+    int getIsolatedNumbers();
+    std::uint64_t getSeed() const;
+    std::pair<int, int> getSafeCell() const; // first click the board was generated for, or (-1, -1)
+    BombPlacement getPlacement() const { return placement; }
+    bool isExploded() const;
+
+    TopologyKind getTopology() const { return topology; }
+    int getRows() const { return rows; }
+    int getCols() const { return cols; }
+    int getTotalBombs() const { return totalBombs; }
+    const Cell& getCell(int row, int col) const { return cells[index(row, col)]; }
+
     std::pair<int, int> autoplaySelectCell();
     void autoplay();
 };
@@ -0,0 +1,184 @@
+#include "FieldStats.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#include <sstream>
+#include <vector>
+
+double FieldStatsSnapshot::visitedPerOpen() const {
+    return opens > 0 ? static_cast<double>(cellsVisited) / opens : 0.0;
+}
+
+double FieldStatsSnapshot::iterationsPerMove() const {
+    return moves > 0 ? static_cast<double>(solverIterations) / moves : 0.0;
+}
+
+long long FieldStatsSnapshot::latencyPercentile(double fraction) const {
+    long long total = 0;
+    for (long long count : latency) {
+        total += count;
+    }
+    long long seen = 0;
+    for (int bucket = 0; bucket < LATENCY_BUCKETS; ++bucket) {
+        seen += latency[bucket];
+        if (total > 0 && seen >= fraction * total) {
+            return 2LL << bucket;
+        }
+    }
+    return 0;
+}
+
+std::string FieldStatsSnapshot::toJson() const {
+    std::ostringstream json;
+    json << "{\"enabled\": " << (FieldStats::isEnabled() ? "true" : "false")
+         << ", \"opens\": " << opens << ", \"cells_visited\": " << cellsVisited
+         << ", \"cells_opened\": " << cellsOpened << ", \"redundant_visits\": " << redundantVisits
+         << ", \"visited_per_open\": " << visitedPerOpen() << ", \"max_visited_per_open\": " << maxVisitedPerOpen
+         << ", \"max_flood_depth\": " << maxFloodDepth << ", \"moves\": " << moves
+         << ", \"solver_iterations\": " << solverIterations << ", \"iterations_per_move\": " << iterationsPerMove()
+         << ", \"max_iterations_per_move\": " << maxIterationsPerMove
+         << ", \"latency_p50_ns\": " << latencyPercentile(0.5) << ", \"latency_p99_ns\": " << latencyPercentile(0.99)
+         << ", \"latency_ns\": [";
+    bool first = true;
+    for (int bucket = 0; bucket < LATENCY_BUCKETS; ++bucket) {
+        if (latency[bucket] > 0) {
+            json << (first ? "" : ", ") << "{\"below\": " << (2LL << bucket) << ", \"count\": " << latency[bucket] << "}";
+            first = false;
+        }
+    }
+    json << "]}";
+    return json.str();
+}
+
+bool FieldStats::dumpJson(const std::string& path) {
+    std::string json = snapshot().toJson() + "\n";
+    std::FILE* file = std::fopen(path.c_str(), "w");
+    if (!file) {
+        return false;
+    }
+    bool ok = std::fwrite(json.data(), 1, json.size(), file) == json.size();
+    return (std::fclose(file) == 0) && ok;
+}
+
+#ifdef FIELD_STATS
+
+namespace {
+
+// Live per-thread blocks, plus the totals of the threads that have exited.
+struct Registry {
+    std::mutex mutex;
+    std::vector<FieldStats::Counters*> live;
+    FieldStatsSnapshot retired;
+
+    Registry() {
+        std::memset(&retired, 0, sizeof(retired));
+    }
+};
+
+Registry& registry() {
+    static Registry instance; // never destroyed before the threads that use it
+    return instance;
+}
+
+void accumulate(FieldStatsSnapshot& total, const FieldStats::Counters& counters) {
+    total.opens += counters.opens.load(std::memory_order_relaxed);
+    total.cellsVisited += counters.cellsVisited.load(std::memory_order_relaxed);
+    total.cellsOpened += counters.cellsOpened.load(std::memory_order_relaxed);
+    total.redundantVisits += counters.redundantVisits.load(std::memory_order_relaxed);
+    total.maxVisitedPerOpen = std::max(total.maxVisitedPerOpen, counters.maxVisitedPerOpen.load(std::memory_order_relaxed));
+    total.maxFloodDepth = std::max(total.maxFloodDepth, counters.maxFloodDepth.load(std::memory_order_relaxed));
+    total.moves += counters.moves.load(std::memory_order_relaxed);
+    total.solverIterations += counters.solverIterations.load(std::memory_order_relaxed);
+    total.maxIterationsPerMove = std::max(total.maxIterationsPerMove, counters.maxIterationsPerMove.load(std::memory_order_relaxed));
+    for (int bucket = 0; bucket < FieldStatsSnapshot::LATENCY_BUCKETS; ++bucket) {
+        total.latency[bucket] += counters.latency[bucket].load(std::memory_order_relaxed);
+    }
+}
+
+void clear(FieldStats::Counters& counters) {
+    counters.opens.store(0, std::memory_order_relaxed);
+    counters.cellsVisited.store(0, std::memory_order_relaxed);
+    counters.cellsOpened.store(0, std::memory_order_relaxed);
+    counters.redundantVisits.store(0, std::memory_order_relaxed);
+    counters.maxVisitedPerOpen.store(0, std::memory_order_relaxed);
+    counters.maxFloodDepth.store(0, std::memory_order_relaxed);
+    counters.moves.store(0, std::memory_order_relaxed);
+    counters.solverIterations.store(0, std::memory_order_relaxed);
+    counters.maxIterationsPerMove.store(0, std::memory_order_relaxed);
+    for (std::atomic<long long>& bucket : counters.latency) {
+        bucket.store(0, std::memory_order_relaxed);
+    }
+}
+
+struct ThreadCounters {
+    FieldStats::Counters counters;
+
+    ThreadCounters() {
+        clear(counters);
+        Registry& shared = registry();
+        std::lock_guard<std::mutex> lock(shared.mutex);
+        shared.live.push_back(&counters);
+    }
+
+    ~ThreadCounters() {
+        Registry& shared = registry();
+        std::lock_guard<std::mutex> lock(shared.mutex);
+        accumulate(shared.retired, counters);
+        shared.live.erase(std::find(shared.live.begin(), shared.live.end(), &counters));
+    }
+};
+
+}
+
+FieldStats::Counters& FieldStats::local() {
+    thread_local ThreadCounters block;
+    return block.counters;
+}
+
+void FieldStats::recordLatency(long long nanoseconds) {
+    int bucket = 0;
+    while (bucket < FieldStatsSnapshot::LATENCY_BUCKETS - 1 && (2LL << bucket) <= nanoseconds) {
+        ++bucket;
+    }
+    add(local().latency[bucket], 1);
+}
+
+bool FieldStats::isEnabled() {
+    return true;
+}
+
+FieldStatsSnapshot FieldStats::snapshot() {
+    Registry& shared = registry();
+    std::lock_guard<std::mutex> lock(shared.mutex);
+    FieldStatsSnapshot total = shared.retired;
+    for (const Counters* counters : shared.live) {
+        accumulate(total, *counters);
+    }
+    return total;
+}
+
+void FieldStats::reset() {
+    Registry& shared = registry();
+    std::lock_guard<std::mutex> lock(shared.mutex);
+    std::memset(&shared.retired, 0, sizeof(shared.retired));
+    for (Counters* counters : shared.live) {
+        clear(*counters);
+    }
+}
+
+#else
+
+bool FieldStats::isEnabled() {
+    return false;
+}
+
+FieldStatsSnapshot FieldStats::snapshot() {
+    FieldStatsSnapshot empty;
+    std::memset(&empty, 0, sizeof(empty));
+    return empty;
+}
+
+void FieldStats::reset() {}
+
+#endif
@@ -0,0 +1,133 @@
+#ifndef FIELDSTATS_H
+#define FIELDSTATS_H
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+// Hot-path counters for Field, the flood fill and the solver, compiled in
+// only when FIELD_STATS is defined (-DFIELD_STATS, for every translation
+// unit). Without it the FIELD_STATS_* macros expand to nothing and
+// snapshot() returns zeros, so instrumented code costs nothing.
+//
+// Every thread counts into its own thread_local block with plain relaxed
+// loads and stores; snapshot() sums the blocks of the live threads and
+// what finished threads left behind.
+
+struct FieldStatsSnapshot {
+    static const int LATENCY_BUCKETS = 40; // bucket b: moves that took [2^b, 2^(b+1)) ns
+
+    long long opens;               // openCell calls that opened something
+    long long cellsVisited;        // cells inspected by the flood or the zero-region walk
+    long long cellsOpened;
+    long long redundantVisits;     // flood runs popped after another run had opened them
+    long long maxVisitedPerOpen;
+    long long maxFloodDepth;       // deepest flood stack
+    long long moves;               // playGame moves
+    long long solverIterations;    // numbers re-examined by the solver
+    long long maxIterationsPerMove;
+    long long latency[LATENCY_BUCKETS];
+
+    double visitedPerOpen() const;
+    double iterationsPerMove() const;
+    // Upper bound of the bucket holding the given fraction of the moves, in ns.
+    long long latencyPercentile(double fraction) const;
+    std::string toJson() const;
+};
+
+class FieldStats {
+public:
+    static bool isEnabled();
+    static FieldStatsSnapshot snapshot();
+    // Only exact while no thread is recording.
+    static void reset();
+    static bool dumpJson(const std::string& path);
+
+#ifdef FIELD_STATS
+    struct Counters {
+        std::atomic<long long> opens;
+        std::atomic<long long> cellsVisited;
+        std::atomic<long long> cellsOpened;
+        std::atomic<long long> redundantVisits;
+        std::atomic<long long> maxVisitedPerOpen;
+        std::atomic<long long> maxFloodDepth;
+        std::atomic<long long> moves;
+        std::atomic<long long> solverIterations;
+        std::atomic<long long> maxIterationsPerMove;
+        std::atomic<long long> latency[FieldStatsSnapshot::LATENCY_BUCKETS];
+    };
+
+    static Counters& local();
+
+    // Only the owning thread writes its counters, so no read-modify-write is needed.
+    static void add(std::atomic<long long>& counter, long long amount) {
+        counter.store(counter.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+    }
+
+    static void raise(std::atomic<long long>& counter, long long value) {
+        if (value > counter.load(std::memory_order_relaxed)) {
+            counter.store(value, std::memory_order_relaxed);
+        }
+    }
+
+    static void recordLatency(long long nanoseconds);
+#endif
+};
+
+#ifdef FIELD_STATS
+
+#include <chrono>
+
+// Counts one openCell and the cells it visited.
+class FieldStatsOpenScope {
+private:
+    FieldStats::Counters& counters;
+    long long visited;
+    long long opened;
+
+public:
+    FieldStatsOpenScope() : counters(FieldStats::local()), visited(counters.cellsVisited.load(std::memory_order_relaxed)),
+        opened(counters.cellsOpened.load(std::memory_order_relaxed)) {}
+
+    ~FieldStatsOpenScope() {
+        if (counters.cellsOpened.load(std::memory_order_relaxed) != opened) {
+            FieldStats::add(counters.opens, 1);
+            FieldStats::raise(counters.maxVisitedPerOpen, counters.cellsVisited.load(std::memory_order_relaxed) - visited);
+        }
+    }
+};
+
+// Times one playGame move and counts the solver work it took.
+class FieldStatsMoveScope {
+private:
+    FieldStats::Counters& counters;
+    long long iterations;
+    std::chrono::steady_clock::time_point start;
+
+public:
+    FieldStatsMoveScope() : counters(FieldStats::local()), iterations(counters.solverIterations.load(std::memory_order_relaxed)),
+        start(std::chrono::steady_clock::now()) {}
+
+    ~FieldStatsMoveScope() {
+        FieldStats::add(counters.moves, 1);
+        FieldStats::raise(counters.maxIterationsPerMove, counters.solverIterations.load(std::memory_order_relaxed) - iterations);
+        FieldStats::recordLatency(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - start).count());
+    }
+};
+
+#define FIELD_STATS_ADD(counter, amount) FieldStats::add(FieldStats::local().counter, (amount))
+#define FIELD_STATS_MAX(counter, value) FieldStats::raise(FieldStats::local().counter, (value))
+#define FIELD_STATS_OPEN_SCOPE() FieldStatsOpenScope fieldStatsOpenScope
+#define FIELD_STATS_MOVE_SCOPE() FieldStatsMoveScope fieldStatsMoveScope
+
+#else
+
+#define FIELD_STATS_ADD(counter, amount) ((void)0)
+#define FIELD_STATS_MAX(counter, value) ((void)0)
+#define FIELD_STATS_OPEN_SCOPE() ((void)0)
+#define FIELD_STATS_MOVE_SCOPE() ((void)0)
+
+#endif
+
+#endif // FIELDSTATS_H
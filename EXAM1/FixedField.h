@@ -0,0 +1,332 @@
+#ifndef FIXEDFIELD_H
+#define FIXEDFIELD_H
+
+#include "BombSampling.h"
+#include "Cell.h"
+#include "Field.h"
+#include "Flood.h"
+#include "Renderer.h"
+#include "Topology.h"
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <utility>
+#include <vector>
+
+// Field with its size fixed at compile time, for the classic presets.
+//
+// Everything lives inside the object (std::array, no heap), so a board can
+// sit on the stack. The cells are framed by a ring of open sentinel cells,
+// so a neighbour is always a constant offset away (NEIGHBOURS) and nothing
+// tests for the edge: the counting pass is a box sum with constant trip
+// counts, chord walks the eight offsets, and the flood is Flood.h's
+// scanline fill in its sentinel-ring form. Bomb placement and the flood
+// are the code Field uses, so a seed gives the same board in both and the
+// same clicks open the same cells in the same order. The interface is
+// Field's square-board one (Solver and playGame run on it), except that
+// getLastRevealed returns a view instead of a vector and there is no
+// parallel generation, zero-region index or journal.
+template <int R, int C>
+class FixedField {
+    static_assert(R > 0 && C > 0, "a board needs at least one cell");
+
+private:
+    static constexpr int CELLS = R * C;
+    static constexpr int PADDED_ROWS = R + 2;
+    static constexpr int PADDED_COLS = C + 2;
+    static constexpr int PADDED_CELLS = PADDED_ROWS * PADDED_COLS;
+    // In the order of SquareTopology::forEachNeighbour.
+    static constexpr std::array<int, 8> NEIGHBOURS = {{-PADDED_COLS - 1, -PADDED_COLS, -PADDED_COLS + 1, -1, 1,
+                                                       PADDED_COLS - 1, PADDED_COLS, PADDED_COLS + 1}};
+    // A flood run can be pushed once from each neighbouring run above and
+    // below it, and a cell lies in at most two extended runs of one row;
+    // on top of that come up to CELLS seeds of one openCells batch.
+    static constexpr int FLOOD_SEEDS = CELLS;
+    static constexpr int FLOOD_CAPACITY = FLOOD_SEEDS + 4 * CELLS;
+
+    std::array<Cell, PADDED_CELLS> cells; // row-major, with the sentinel ring
+    int totalBombs;
+    int openedCells;
+    std::uint64_t seed;
+    int safeRow;
+    int safeCol;
+    bool exploded;
+
+    std::array<RevealedSpan, CELLS> revealed;
+    int revealedCount;
+    FixedStack<std::pair<int, int>, FLOOD_CAPACITY> floodStack; // padded coordinates
+
+    static constexpr int at(int row, int col) {
+        return (row + 1) * PADDED_COLS + col + 1;
+    }
+
+    static constexpr int at(std::size_t boardIndex) {
+        return at(static_cast<int>(boardIndex / C), static_cast<int>(boardIndex % C));
+    }
+
+    // Closed cells inside, open sentinels around them.
+    void clearCells() {
+        cells.fill(Cell());
+        for (int col = 0; col < PADDED_COLS; ++col) {
+            cells[col].setOpen();
+            cells[(PADDED_ROWS - 1) * PADDED_COLS + col].setOpen();
+        }
+        for (int row = 1; row < PADDED_ROWS - 1; ++row) {
+            cells[row * PADDED_COLS].setOpen();
+            cells[row * PADDED_COLS + PADDED_COLS - 1].setOpen();
+        }
+    }
+
+    bool isFloodable(int i) const {
+        const Cell& cell = cells[i];
+        return !cell.getOpen() && !cell.getFlagged() && !cell.getBomb() && cell.getBombsNearby() == 0;
+    }
+
+    bool isClosedSafe(int i) const {
+        const Cell& cell = cells[i];
+        return !cell.getOpen() && !cell.getFlagged() && !cell.getBomb();
+    }
+
+    void revealOne(int row, int col) {
+        cells[at(row, col)].setOpen();
+        ++openedCells;
+        if (revealedCount > 0 && revealed[revealedCount - 1].row == row && revealed[revealedCount - 1].lastCol + 1 == col) {
+            revealed[revealedCount - 1].lastCol = col;
+        }
+        else {
+            revealed[revealedCount++] = {row, col, col};
+        }
+    }
+
+    // Field::addFloodSeed: queue a zero cell, open a number right away.
+    void addFloodSeed(int row, int col) {
+        if (isFloodable(at(row, col))) {
+            if (static_cast<int>(floodStack.size()) == FLOOD_SEEDS) {
+                runFlood(); // only a batch naming the same cells over and over gets here
+            }
+            floodStack.push_back(std::make_pair(row + 1, col + 1));
+            return;
+        }
+        if (isClosedSafe(at(row, col))) {
+            revealOne(row, col);
+        }
+    }
+
+    void runFlood() {
+        auto floodable = [this](int r, int c) {
+            return isFloodable(r * PADDED_COLS + c);
+        };
+        auto open = [this](int r, int c) {
+            if (isClosedSafe(r * PADDED_COLS + c)) {
+                revealOne(r - 1, c - 1);
+            }
+        };
+        scanlineFlood<true>(PADDED_ROWS, PADDED_COLS, floodStack, floodable, open);
+    }
+
+    // Field::openSeed, without the journal.
+    void openSeed(int row, int col, OpenStatus& status) {
+        if (row < 0 || row >= R || col < 0 || col >= C) {
+            ++status.skipped;
+            return;
+        }
+        Cell& cell = cells[at(row, col)];
+        if (cell.getFlagged() || cell.getOpen()) {
+            ++status.skipped;
+            return;
+        }
+        if (cell.getBomb()) {
+            cell.setOpen();
+            exploded = true;
+            revealed[revealedCount++] = {row, col, col};
+            if (!status.exploded) {
+                status.exploded = true;
+                status.bombRow = row;
+                status.bombCol = col;
+            }
+            return;
+        }
+        addFloodSeed(row, col);
+    }
+
+public:
+    explicit FixedField(int bombs) : totalBombs(bombs), openedCells(0), seed(0), safeRow(-1), safeCol(-1),
+        exploded(false), revealedCount(0) {
+        clearCells();
+    }
+
+    void placeBombs() {
+        std::random_device rd;
+        placeBombs((static_cast<std::uint64_t>(rd()) << 32) | rd());
+    }
+
+    void placeBombs(std::uint64_t boardSeed) {
+        placeBombs(boardSeed, -1, -1);
+    }
+
+    void placeBombs(std::uint64_t boardSeed, int firstRow, int firstCol) {
+        clearCells();
+        openedCells = 0;
+        exploded = false;
+        revealedCount = 0;
+        seed = boardSeed;
+        safeRow = firstRow;
+        safeCol = firstCol;
+
+        std::size_t excluded[SAFE_ZONE_CELLS];
+        std::size_t excludedCount = safeZone<SquareTopology>(R, C, firstRow, firstCol, totalBombs, excluded);
+        std::size_t bombs = std::min(static_cast<std::size_t>(std::max(totalBombs, 0)), CELLS - excludedCount);
+        sampleBombs([this](std::size_t i) -> Cell& { return cells[at(i)]; }, 0, CELLS, bombs, excluded, excludedCount,
+                    boardSeed);
+    }
+
+    // Separable box sum over the bomb bits: the sentinels hold no bombs, so
+    // every loop has a constant trip count and no border test.
+    void calculateBombsNearby() {
+        std::array<unsigned char, PADDED_CELLS> bombs;
+        std::array<unsigned char, PADDED_CELLS> across; // bombs in the 1x3 run centred on a cell
+        for (int i = 0; i < PADDED_CELLS; ++i) {
+            bombs[i] = cells[i].getBomb() ? 1 : 0;
+        }
+        across[0] = 0;
+        across[PADDED_CELLS - 1] = 0;
+        for (int i = 1; i < PADDED_CELLS - 1; ++i) {
+            across[i] = static_cast<unsigned char>(bombs[i - 1] + bombs[i] + bombs[i + 1]);
+        }
+        for (int row = 0; row < R; ++row) {
+            for (int col = 0; col < C; ++col) {
+                int centre = at(row, col);
+                int count = across[centre - PADDED_COLS] + across[centre] + across[centre + PADDED_COLS] - bombs[centre];
+                Cell& cell = cells[centre];
+                cell.setBombsNearby(cell.getBomb() ? cell.getBombsNearby() : count);
+            }
+        }
+    }
+
+    bool openCell(int row, int col) {
+        revealedCount = 0;
+        Cell& cell = cells[at(row, col)];
+        if (cell.getFlagged()) {
+            std::cout << "Cell is flagged. Unflag it before opening." << std::endl;
+            return false;
+        }
+        if (cell.getOpen()) {
+            std::cout << "Cell is already open." << std::endl;
+            return false;
+        }
+        if (cell.getBomb()) {
+            cell.setOpen();
+            exploded = true;
+            revealed[revealedCount++] = {row, col, col};
+            return true;
+        }
+        floodStack.clear();
+        addFloodSeed(row, col);
+        runFlood();
+        return true;
+    }
+
+    // Same as Field::openCells: the zero cells among the seeds are flooded
+    // together at the end.
+    OpenStatus openCells(const std::pair<int, int>* coords, std::size_t count) {
+        OpenStatus status = {0, 0, false, -1, -1, false};
+        revealedCount = 0;
+        floodStack.clear();
+        int openedBefore = openedCells;
+        for (std::size_t i = 0; i < count; ++i) {
+            openSeed(coords[i].first, coords[i].second, status);
+        }
+        runFlood();
+        status.opened = openedCells - openedBefore;
+        return status;
+    }
+
+    OpenStatus openCells(const std::vector<std::pair<int, int>>& coords) {
+        return openCells(coords.data(), coords.size());
+    }
+
+    // Same as Field::chord.
+    OpenStatus chord(int row, int col) {
+        OpenStatus status = {0, 0, false, -1, -1, false};
+        revealedCount = 0;
+        floodStack.clear();
+        if (row < 0 || row >= R || col < 0 || col >= C) {
+            status.refused = true;
+            return status;
+        }
+        int centre = at(row, col);
+        if (!cells[centre].getOpen() || cells[centre].getBomb() || cells[centre].getBombsNearby() == 0) {
+            status.refused = true;
+            return status;
+        }
+        int flags = 0;
+        for (int offset : NEIGHBOURS) {
+            flags += cells[centre + offset].getFlagged() ? 1 : 0;
+        }
+        if (flags != cells[centre].getBombsNearby()) {
+            status.refused = true;
+            return status;
+        }
+
+        int openedBefore = openedCells;
+        for (int offset : NEIGHBOURS) {
+            const Cell& cell = cells[centre + offset];
+            if (!cell.getOpen() && !cell.getFlagged()) { // never a sentinel
+                openSeed((centre + offset) / PADDED_COLS - 1, (centre + offset) % PADDED_COLS - 1, status);
+            }
+        }
+        runFlood();
+        status.opened = openedCells - openedBefore;
+        return status;
+    }
+
+    void flagCell(int row, int col) {
+        Cell& cell = cells[at(row, col)];
+        if (cell.getOpen()) {
+            std::cout << "Cannot flag an open cell." << std::endl;
+            return;
+        }
+        cell.setFlagged(!cell.getFlagged());
+    }
+
+    bool checkWin() const {
+        return openedCells == CELLS - totalBombs;
+    }
+
+    void displayField(bool showBombs) const {
+        std::array<char, R * (2 * C + 1)> frame;
+        std::size_t length = 0;
+        for (int i = 0; i < R; ++i) {
+            for (int j = 0; j < C; ++j) {
+                frame[length++] = cellGlyph(cells[at(i, j)], showBombs);
+                frame[length++] = ' ';
+            }
+            frame[length++] = '\n';
+        }
+        std::cout.write(frame.data(), static_cast<std::streamsize>(length));
+        std::cout.flush();
+    }
+
+    RevealedRange getLastRevealed() const {
+        return {revealed.data(), revealed.data() + revealedCount};
+    }
+
+    std::uint64_t getSeed() const { return seed; }
+    std::pair<int, int> getSafeCell() const { return std::make_pair(safeRow, safeCol); }
+    bool isExploded() const { return exploded; }
+
+    static constexpr TopologyKind getTopology() { return TOPOLOGY_SQUARE; }
+    static constexpr int getRows() { return R; }
+    static constexpr int getCols() { return C; }
+    int getTotalBombs() const { return totalBombs; }
+    const Cell& getCell(int row, int col) const { return cells[at(row, col)]; }
+};
+
+using BeginnerField = FixedField<9, 9>;
+using IntermediateField = FixedField<16, 16>;
+using ExpertField = FixedField<16, 30>;
+
+#endif // FIXEDFIELD_H
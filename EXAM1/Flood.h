@@ -0,0 +1,116 @@
+#ifndef FLOOD_H
+#define FLOOD_H
+
+#include "FieldStats.h"
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <utility>
+
+// The flood fills behind Field::openCells, for any board that can answer
+// two questions about its cells, so boards that store cells differently
+// (Field, TiledField) open the same cells in the same order:
+//   floodable(r, c)  closed, unflagged, no bomb and no bombs around it
+//   open(r, c)       opens the cell if it is closed, unflagged and no bomb
+// Both expand every seed on `stack` until it is empty. A seed may be any
+// cell; one that is not floodable is skipped. The stack is anything with
+// empty, back, pop_back, push_back and size over std::pair<int, int>: a
+// std::vector, or a FixedStack for boards that must not allocate.
+
+// A stack in a std::array, for a flood whose depth is bounded in advance.
+template <typename T, std::size_t N>
+class FixedStack {
+private:
+    std::array<T, N> items;
+    std::size_t depth = 0;
+
+public:
+    bool empty() const { return depth == 0; }
+    std::size_t size() const { return depth; }
+    const T& back() const { return items[depth - 1]; }
+    void pop_back() { --depth; }
+    void push_back(const T& item) { items[depth++] = item; }
+    void clear() { depth = 0; }
+};
+
+// Scanline flood fill for square boards. Every zero cell is opened exactly
+// once as part of a horizontal run, the stack only holds one entry per
+// run, and numbered cells on the border are opened without being pushed.
+//
+// With SentinelRing the board is framed by a ring of cells that are never
+// floodable and that open leaves alone (rows and cols count the ring), so
+// the runs stop on the ring by themselves and every edge test is compiled
+// out. The cells are opened in the same order either way.
+template <bool SentinelRing = false, typename Stack, typename Floodable, typename Open>
+void scanlineFlood(int rows, int cols, Stack& stack, Floodable floodable, Open open) {
+    while (!stack.empty()) {
+        FIELD_STATS_MAX(maxFloodDepth, static_cast<long long>(stack.size()));
+        int r = stack.back().first;
+        int c = stack.back().second;
+        stack.pop_back();
+        if (!floodable(r, c)) {
+            FIELD_STATS_ADD(redundantVisits, 1);
+            continue; // already opened as part of another run
+        }
+
+        int left = c;
+        while ((SentinelRing || left > 0) && floodable(r, left - 1)) {
+            --left;
+        }
+        int right = c;
+        while ((SentinelRing || right < cols - 1) && floodable(r, right + 1)) {
+            ++right;
+        }
+
+        int first = SentinelRing ? left - 1 : std::max(0, left - 1);
+        int last = SentinelRing ? right + 1 : std::min(cols - 1, right + 1);
+        FIELD_STATS_ADD(cellsVisited, (last - first + 1) * (1 + (r > 0 ? 1 : 0) + (r < rows - 1 ? 1 : 0)));
+        for (int j = first; j <= last; ++j) {
+            open(r, j);
+        }
+
+        for (int nr = r - 1; nr <= r + 1; nr += 2) {
+            if (!SentinelRing && (nr < 0 || nr >= rows)) {
+                continue;
+            }
+            for (int j = first; j <= last; ++j) {
+                if (floodable(nr, j)) {
+                    stack.push_back(std::make_pair(nr, j));
+                    while (j < last && floodable(nr, j + 1)) {
+                        ++j;
+                    }
+                    continue;
+                }
+                open(nr, j);
+            }
+        }
+    }
+}
+
+// Cell-by-cell flood for topologies whose runs wrap or shift: a zero cell
+// is opened when popped and pushes its floodable neighbours; numbered
+// neighbours are opened right away.
+template <typename Topology, typename Stack, typename Floodable, typename Open>
+void neighbourFlood(int rows, int cols, Stack& stack, Floodable floodable, Open open) {
+    while (!stack.empty()) {
+        FIELD_STATS_MAX(maxFloodDepth, static_cast<long long>(stack.size()));
+        int r = stack.back().first;
+        int c = stack.back().second;
+        stack.pop_back();
+        if (!floodable(r, c)) {
+            FIELD_STATS_ADD(redundantVisits, 1);
+            continue;
+        }
+        open(r, c);
+        Topology::forEachNeighbour(r, c, rows, cols, [&stack, &floodable, &open](int nr, int nc) {
+            FIELD_STATS_ADD(cellsVisited, 1);
+            if (floodable(nr, nc)) {
+                stack.push_back(std::make_pair(nr, nc));
+                return;
+            }
+            open(nr, nc);
+        });
+    }
+}
+
+#endif // FLOOD_H
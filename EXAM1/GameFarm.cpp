@@ -0,0 +1,101 @@
+#include "GameFarm.h"
+#include "Random.h"
+#include <algorithm>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace {
+
+struct Batch {
+    long long first;
+    long long last; // exclusive
+};
+
+class WorkQueue {
+private:
+    std::mutex mutex;
+    std::deque<Batch> batches;
+
+public:
+    void push(const Batch& batch) {
+        std::lock_guard<std::mutex> lock(mutex);
+        batches.push_back(batch);
+    }
+
+    bool popBack(Batch& batch) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (batches.empty()) {
+            return false;
+        }
+        batch = batches.back();
+        batches.pop_back();
+        return true;
+    }
+
+    bool stealFront(Batch& batch) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (batches.empty()) {
+            return false;
+        }
+        batch = batches.front();
+        batches.pop_front();
+        return true;
+    }
+};
+
+// Padded so that neighbouring threads' counters never share a cache line.
+struct alignas(64) WorkerStats {
+    SimulationStats stats;
+};
+
+void worker(int id, const FarmConfig& config, std::vector<WorkQueue>& queues, WorkerStats& result) {
+    Field field(config.rows, config.cols, config.bombs);
+    int threads = static_cast<int>(queues.size());
+    Batch batch;
+    for (;;) {
+        bool found = queues[id].popBack(batch);
+        for (int offset = 1; !found && offset < threads; ++offset) {
+            found = queues[(id + offset) % threads].stealFront(batch);
+        }
+        if (!found) {
+            return; // no new work is ever added, so every queue is drained
+        }
+        for (long long game = batch.first; game < batch.last; ++game) {
+            field.placeBombs(deriveSeed(config.masterSeed, static_cast<std::uint64_t>(game)), config.rows / 2, config.cols / 2);
+            field.calculateBombsNearby();
+            result.stats.add(playGame(field));
+        }
+    }
+}
+
+}
+
+SimulationStats runGameFarm(const FarmConfig& config) {
+    int threads = config.threads > 0 ? config.threads : static_cast<int>(std::thread::hardware_concurrency());
+    threads = std::max(threads, 1);
+    long long batchSize = std::max(config.batchSize, 1);
+
+    std::vector<WorkQueue> queues(threads);
+    long long batchIndex = 0;
+    for (long long first = 0; first < config.games; first += batchSize, ++batchIndex) {
+        queues[batchIndex % threads].push({first, std::min(first + batchSize, config.games)});
+    }
+
+    std::vector<WorkerStats> results(threads);
+    std::vector<std::thread> pool;
+    for (int id = 1; id < threads; ++id) {
+        pool.emplace_back(worker, id, std::cref(config), std::ref(queues), std::ref(results[id]));
+    }
+    worker(0, config, queues, results[0]);
+    for (std::thread& thread : pool) {
+        thread.join();
+    }
+
+    SimulationStats total;
+    for (const WorkerStats& result : results) {
+        total.merge(result.stats);
+    }
+    return total;
+}
@@ -0,0 +1,28 @@
+#ifndef GAMEFARM_H
+#define GAMEFARM_H
+
+#include "Simulation.h"
+#include <cstdint>
+
+struct FarmConfig {
+    int rows;
+    int cols;
+    int bombs;
+    std::uint64_t masterSeed;
+    long long games;
+    int threads;   // 0: one per hardware thread
+    int batchSize; // games handed out (or stolen) at a time
+};
+
+// Plays config.games independent games on a pool of threads.
+//
+// Game i is always generated from deriveSeed(masterSeed, i), whichever
+// thread ends up playing it, so every counter of the result (games, wins,
+// moves, guesses) is identical for any thread count; only the timings
+// differ. The game range is split into batches dealt round-robin to
+// per-thread deques. A thread takes batches from the back of its own deque
+// and, once that is empty, steals from the front of the others. Each thread
+// accumulates into its own SimulationStats; they are merged at the end.
+SimulationStats runGameFarm(const FarmConfig& config);
+
+#endif // GAMEFARM_H
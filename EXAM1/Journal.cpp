@@ -0,0 +1,214 @@
+#include "Journal.h"
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <stdexcept>
+
+namespace {
+
+const char MAGIC[8] = {'M', 'I', 'N', 'E', 'J', 'R', 'N', 'L'};
+
+void putVarint(std::vector<unsigned char>& out, std::uint32_t value) {
+    while (value >= 0x80) {
+        out.push_back(static_cast<unsigned char>(value | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<unsigned char>(value));
+}
+
+bool getVarint(const std::vector<unsigned char>& in, std::size_t& pos, std::uint32_t& value) {
+    value = 0;
+    for (int shift = 0; shift < 35 && pos < in.size(); shift += 7) {
+        unsigned char byte = in[pos++];
+        value |= static_cast<std::uint32_t>(byte & 0x7F) << shift;
+        if (!(byte & 0x80)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+}
+
+MoveJournal::MoveJournal() : moves(0) {
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = VERSION;
+    header.safeRow = -1;
+    header.safeCol = -1;
+}
+
+void MoveJournal::begin(const Field& field) {
+    header.rows = field.getRows();
+    header.cols = field.getCols();
+    header.totalBombs = field.getTotalBombs();
+    header.seed = field.getSeed();
+    header.safeRow = field.getSafeCell().first;
+    header.safeCol = field.getSafeCell().second;
+    header.topology = field.getTopology();
+    header.placement = field.getPlacement();
+    records.clear();
+    moves = 0;
+    file.reset();
+}
+
+void MoveJournal::record(JournalAction action, int row, int col) {
+    std::size_t start = records.size();
+    putVarint(records, static_cast<std::uint32_t>(row));
+    putVarint(records, static_cast<std::uint32_t>(col) * 2 + action);
+    ++moves;
+    if (file) {
+        std::fwrite(records.data() + start, 1, records.size() - start, file.get());
+    }
+}
+
+bool MoveJournal::attachFile(const std::string& path) {
+    file.reset(std::fopen(path.c_str(), "wb"));
+    if (!file) {
+        return false;
+    }
+    bool ok = std::fwrite(&header, sizeof(header), 1, file.get()) == 1 &&
+              std::fwrite(records.data(), 1, records.size(), file.get()) == records.size();
+    if (!ok) {
+        file.reset();
+    }
+    return ok;
+}
+
+void MoveJournal::flush() {
+    if (file) {
+        std::fflush(file.get());
+    }
+}
+
+bool MoveJournal::save(const std::string& path) const {
+    std::FILE* out = std::fopen(path.c_str(), "wb");
+    if (!out) {
+        return false;
+    }
+    bool ok = std::fwrite(&header, sizeof(header), 1, out) == 1 &&
+              std::fwrite(records.data(), 1, records.size(), out) == records.size();
+    return (std::fclose(out) == 0) && ok;
+}
+
+MoveJournal MoveJournal::load(const std::string& path) {
+    std::FILE* in = std::fopen(path.c_str(), "rb");
+    if (!in) {
+        throw std::runtime_error("Cannot open journal: " + path);
+    }
+    MoveJournal journal;
+    bool read = std::fread(&journal.header, sizeof(journal.header), 1, in) == 1;
+    unsigned char buffer[4096];
+    for (std::size_t got; read && (got = std::fread(buffer, 1, sizeof(buffer), in)) > 0;) {
+        journal.records.insert(journal.records.end(), buffer, buffer + got);
+    }
+    std::fclose(in);
+
+    if (!read || std::memcmp(journal.header.magic, MAGIC, sizeof(MAGIC)) != 0) {
+        throw std::runtime_error("Not a minesweeper journal: " + path);
+    }
+    if (journal.header.version != VERSION) {
+        throw std::runtime_error("Unsupported journal version: " + path);
+    }
+    if (journal.header.topology > TOPOLOGY_HEX || journal.header.placement > PLACEMENT_PARALLEL) {
+        throw std::runtime_error("Corrupt journal header: " + path);
+    }
+
+    // Count the records and drop a last one cut short by a crash.
+    std::size_t pos = 0;
+    std::size_t complete = 0;
+    std::uint32_t value;
+    while (pos < journal.records.size() && getVarint(journal.records, pos, value) &&
+           getVarint(journal.records, pos, value)) {
+        complete = pos;
+        ++journal.moves;
+    }
+    journal.records.resize(complete);
+    return journal;
+}
+
+const JournalHeader& MoveJournal::getHeader() const {
+    return header;
+}
+
+std::size_t MoveJournal::getMoveCount() const {
+    return moves;
+}
+
+std::size_t MoveJournal::getByteSize() const {
+    return records.size();
+}
+
+void MoveJournal::decode(std::vector<JournalEntry>& entries) const {
+    entries.clear();
+    entries.reserve(moves);
+    std::size_t pos = 0;
+    std::uint32_t row;
+    std::uint32_t packed;
+    while (getVarint(records, pos, row) && getVarint(records, pos, packed)) {
+        entries.push_back({static_cast<int>(row), static_cast<int>(packed >> 1), static_cast<JournalAction>(packed & 1)});
+    }
+}
+
+Replay::Replay(const MoveJournal& journal, std::size_t interval)
+    : field(journal.getHeader().rows, journal.getHeader().cols, journal.getHeader().totalBombs,
+            static_cast<TopologyKind>(journal.getHeader().topology)),
+      position(0), keyframeInterval(std::max<std::size_t>(interval, 1)) {
+    const JournalHeader& header = journal.getHeader();
+    if (header.placement == PLACEMENT_PARALLEL) {
+        field.placeBombsParallel(header.seed, header.safeRow, header.safeCol);
+        field.calculateBombsNearbyParallel();
+    }
+    else {
+        field.placeBombs(header.seed, header.safeRow, header.safeCol);
+        field.calculateBombsNearby();
+    }
+    journal.decode(entries);
+    keyframes.push_back(field);
+}
+
+void Replay::apply(const JournalEntry& entry) {
+    if (entry.action == JOURNAL_OPEN) {
+        std::pair<int, int> cell(entry.row, entry.col);
+        field.openCells(&cell, 1); // silent if a batch had already opened it
+    }
+    else {
+        field.flagCell(entry.row, entry.col);
+    }
+    ++position;
+    if (position % keyframeInterval == 0 && keyframes.size() == position / keyframeInterval) {
+        keyframes.push_back(field);
+    }
+}
+
+void Replay::seek(std::size_t move) {
+    move = std::min(move, entries.size());
+    std::size_t keyframe = std::min(move / keyframeInterval, keyframes.size() - 1);
+    if (move < position || keyframe * keyframeInterval > position) {
+        field = keyframes[keyframe];
+        position = keyframe * keyframeInterval;
+    }
+    while (position < move) {
+        apply(entries[position]);
+    }
+}
+
+bool Replay::step() {
+    if (position >= entries.size()) {
+        return false;
+    }
+    apply(entries[position]);
+    return true;
+}
+
+const Field& Replay::getField() const {
+    return field;
+}
+
+std::size_t Replay::getPosition() const {
+    return position;
+}
+
+std::size_t Replay::getMoveCount() const {
+    return entries.size();
+}
@@ -0,0 +1,102 @@
+#ifndef JOURNAL_H
+#define JOURNAL_H
+
+#include "Field.h"
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+
+// On-disk layout (little-endian), version 1:
+//   JournalHeader, then one record per action until the end of the file:
+//   varint(row), varint(col * 2 + action). A move on a 16x30 board takes
+//   two bytes, on boards up to 8192 wide at most four.
+// Only the seed, the safe click and how the bombs were placed are stored,
+// so a journal can only be replayed for boards placed with placeBombs or
+// placeBombsParallel(seed, row, col).
+struct JournalHeader {
+    char magic[8];
+    std::uint32_t version;
+    std::int32_t rows;
+    std::int32_t cols;
+    std::int32_t totalBombs;
+    std::uint64_t seed;
+    std::int32_t safeRow;
+    std::int32_t safeCol;
+    std::uint32_t topology;  // TopologyKind
+    std::uint32_t placement; // BombPlacement
+};
+
+enum JournalAction : unsigned char { JOURNAL_OPEN = 0, JOURNAL_FLAG = 1 };
+
+struct JournalEntry {
+    int row;
+    int col;
+    JournalAction action;
+};
+
+// Append-only record of the openCell/flagCell calls that changed a Field.
+// Attach it with Field::setJournal; the records are kept in memory and,
+// after attachFile, also appended to a file as they happen, so a crash
+// loses at most what stdio had buffered.
+class MoveJournal {
+private:
+    struct FileCloser {
+        void operator ()(std::FILE* file) const { std::fclose(file); }
+    };
+
+    JournalHeader header;
+    std::vector<unsigned char> records;
+    std::size_t moves;
+    std::unique_ptr<std::FILE, FileCloser> file;
+
+public:
+    static const std::uint32_t VERSION = 1;
+
+    MoveJournal();
+
+    // Starts a new journal for the board as it is now placed.
+    void begin(const Field& field);
+    void record(JournalAction action, int row, int col);
+
+    // Writes the journal so far to path and keeps appending to it.
+    bool attachFile(const std::string& path);
+    void flush();
+    bool save(const std::string& path) const;
+    // Throws std::runtime_error for a missing, foreign or corrupt file.
+    static MoveJournal load(const std::string& path);
+
+    const JournalHeader& getHeader() const;
+    std::size_t getMoveCount() const;
+    std::size_t getByteSize() const; // records only
+    void decode(std::vector<JournalEntry>& entries) const;
+};
+
+// Rebuilds the game state after any move of a journal by regenerating the
+// board from its seed, topology and placement and replaying the actions. A copy of the board is
+// kept every keyframeInterval moves the first time replay passes it, so
+// seeking costs a board copy plus at most keyframeInterval moves.
+class Replay {
+private:
+    Field field;
+    std::vector<JournalEntry> entries;
+    std::size_t position;
+    std::size_t keyframeInterval;
+    std::vector<Field> keyframes; // keyframes[k]: state after k * keyframeInterval moves
+
+    void apply(const JournalEntry& entry);
+
+public:
+    explicit Replay(const MoveJournal& journal, std::size_t interval = 256);
+
+    // Brings the board to the state after the first `move` moves.
+    void seek(std::size_t move);
+    bool step(); // false at the end of the journal
+
+    const Field& getField() const;
+    std::size_t getPosition() const;
+    std::size_t getMoveCount() const;
+};
+
+#endif // JOURNAL_H
@@ -0,0 +1,221 @@
+#include "NoGuessGenerator.h"
+#include "Solver.h"
+#include <algorithm>
+
+NoGuessGenerator::NoGuessGenerator(int repairLimit) : maxRepairs(repairLimit), repairs(0) {}
+
+// Plays the board with the local rules only; true if that wins it.
+bool NoGuessGenerator::solve(Field& board) {
+    Solver solver(board);
+    for (Move move = solver.nextDeducedMove(); move.row != -1; move = solver.nextDeducedMove()) {
+        board.openCell(move.row, move.col);
+        solver.onCellsRevealed(board.getLastRevealed());
+        if (board.isExploded()) {
+            return false;
+        }
+    }
+    return board.checkWin();
+}
+
+bool NoGuessGenerator::repair(Field& board, SplitMix64& random) {
+    bool repaired = false;
+    withTopology(board.getTopology(), [this, &board, &random, &repaired](auto policy) {
+        repaired = repairWith<decltype(policy)>(board, random);
+    });
+    return repaired;
+}
+
+// Moves one mine off the edge of the revealed area to a closed cell that
+// touches no open cell, so the numbers already shown only change around
+// the mine that left. Unproven mines are moved first; a flagged one only
+// if nothing else borders the revealed area. Near the end of a game there
+// may be no such cell left; the board is then given up on, since moving
+// mines next to open numbers tends to just shift the problem around.
+template <typename Topology>
+bool NoGuessGenerator::repairWith(Field& board, SplitMix64& random) {
+    int rows = board.getRows();
+    int cols = board.getCols();
+    stuckMines.clear();
+    flaggedMines.clear();
+    targets.clear();
+    for (int row = 0; row < rows; ++row) {
+        for (int col = 0; col < cols; ++col) {
+            const Cell& cell = board.getCell(row, col);
+            if (cell.getOpen()) {
+                continue;
+            }
+            bool touchesOpen = false;
+            Topology::forEachNeighbour(row, col, rows, cols, [&board, &touchesOpen](int r, int c) {
+                touchesOpen = touchesOpen || board.getCell(r, c).getOpen();
+            });
+            if (cell.getBomb() && touchesOpen) {
+                (cell.getFlagged() ? flaggedMines : stuckMines).push_back(row * cols + col);
+            }
+            else if (!cell.getBomb() && !touchesOpen) {
+                targets.push_back(row * cols + col);
+            }
+        }
+    }
+    // Unproven mines first, each group in board order.
+    std::size_t unproven = stuckMines.size();
+    stuckMines.insert(stuckMines.end(), flaggedMines.begin(), flaggedMines.end());
+    if (stuckMines.empty() || targets.empty()) {
+        return false;
+    }
+
+    int from = stuckMines[random.nextBelow(unproven > 0 ? unproven : stuckMines.size())];
+    int to = targets[random.nextBelow(targets.size())];
+    int fromRow = from / cols;
+    int fromCol = from % cols;
+    if (board.getCell(fromRow, fromCol).getFlagged()) {
+        board.flagCell(fromRow, fromCol);
+    }
+    board.moveBomb(fromRow, fromCol, to / cols, to % cols);
+    ++repairs;
+
+    // An open number next to the old mine may have dropped to zero; open
+    // around it the way the flood would have.
+    Topology::forEachNeighbour(fromRow, fromCol, rows, cols, [&board, rows, cols](int r, int c) {
+        const Cell& cell = board.getCell(r, c);
+        if (!cell.getOpen() || cell.getBombsNearby() != 0) {
+            return;
+        }
+        Topology::forEachNeighbour(r, c, rows, cols, [&board](int nr, int nc) {
+            const Cell& next = board.getCell(nr, nc);
+            if (!next.getOpen() && !next.getFlagged()) {
+                board.openCell(nr, nc);
+            }
+        });
+    });
+    return true;
+}
+
+bool NoGuessGenerator::generate(std::uint64_t seed, int safeRow, int safeCol, Field& board) {
+    board.placeBombs(seed, safeRow, safeCol);
+    board.calculateBombsNearby();
+    SplitMix64 random(deriveSeed(seed, 1)); // a stream apart from the one placeBombs used
+
+    // Moving a mine can invalidate a deduction made before the move, so a
+    // board is only accepted once it solves from the first click again.
+    for (int attempt = 0;; ++attempt) {
+        if (solve(board)) {
+            board.resetPlay();
+            if (solve(board)) {
+                board.resetPlay();
+                return true;
+            }
+        }
+        if (attempt == maxRepairs || !repair(board, random)) {
+            board.resetPlay();
+            return false;
+        }
+    }
+}
+
+long long NoGuessGenerator::getRepairs() const {
+    return repairs;
+}
+
+NoGuessPool::NoGuessPool(int numRows, int numCols, int numBombs, std::uint64_t seed, std::size_t poolCapacity, int threads,
+                         std::uint64_t giveUpAfter)
+    : rows(numRows), cols(numCols), bombs(numBombs), masterSeed(seed), capacity(std::max<std::size_t>(poolCapacity, 1)),
+      failureLimit(std::max<std::uint64_t>(giveUpAfter, 1)), nextAttempt(0), failuresInARow(0), exhausted(false),
+      stopping(false) {
+    if (threads <= 0) {
+        threads = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+    }
+    for (int i = 0; i < threads; ++i) {
+        workers.emplace_back(&NoGuessPool::work, this);
+    }
+}
+
+NoGuessPool::~NoGuessPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    notFull.notify_all();
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+}
+
+void NoGuessPool::work() {
+    NoGuessGenerator generator;
+    Field board(rows, cols, bombs);
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            notFull.wait(lock, [this] { return stopping || exhausted || ready.size() < capacity; });
+            if (stopping || exhausted) {
+                return;
+            }
+        }
+        std::uint64_t attempt = nextAttempt.fetch_add(1, std::memory_order_relaxed);
+        bool generated = generator.generate(deriveSeed(masterSeed, attempt), rows / 2, cols / 2, board);
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            if (!generated) {
+                if (++failuresInARow < failureLimit) {
+                    continue;
+                }
+                exhausted = true;
+                lock.unlock();
+                notEmpty.notify_all(); // takers waiting on an empty pool give up
+                notFull.notify_all();
+                return;
+            }
+            failuresInARow = 0;
+            // Other workers may have filled the pool while this board was
+            // generated; keep it until there is room.
+            notFull.wait(lock, [this] { return stopping || ready.size() < capacity; });
+            if (stopping) {
+                return;
+            }
+            ready.push_back(board);
+        }
+        notEmpty.notify_one();
+    }
+}
+
+bool NoGuessPool::take(Field& board) {
+    std::unique_lock<std::mutex> lock(mutex);
+    notEmpty.wait(lock, [this] { return exhausted || !ready.empty(); });
+    if (ready.empty()) {
+        return false;
+    }
+    board = std::move(ready.front());
+    ready.pop_front();
+    lock.unlock();
+    notFull.notify_one();
+    return true;
+}
+
+bool NoGuessPool::takeFor(Field& board, std::chrono::milliseconds timeout) {
+    std::unique_lock<std::mutex> lock(mutex);
+    if (!notEmpty.wait_for(lock, timeout, [this] { return exhausted || !ready.empty(); }) || ready.empty()) {
+        return false;
+    }
+    board = std::move(ready.front());
+    ready.pop_front();
+    lock.unlock();
+    notFull.notify_one();
+    return true;
+}
+
+bool NoGuessPool::tryTake(Field& board) {
+    std::unique_lock<std::mutex> lock(mutex);
+    if (ready.empty()) {
+        return false;
+    }
+    board = std::move(ready.front());
+    ready.pop_front();
+    lock.unlock();
+    notFull.notify_one();
+    return true;
+}
+
+std::size_t NoGuessPool::available() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return ready.size();
+}
@@ -0,0 +1,93 @@
+#ifndef NOGUESSGENERATOR_H
+#define NOGUESSGENERATOR_H
+
+#include "Field.h"
+#include "Random.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Boards that the solver's local rules clear from the first click without
+// a single guess.
+//
+// A board is placed and counted as usual and played by the solver. Where
+// it gets stuck, one mine touching the revealed area is moved to a random
+// closed cell away from it; the counts are patched around the two cells
+// and solving resumes from the current position, so a board needs a few
+// cheap repairs instead of being regenerated from scratch. A board that
+// cannot be repaired within maxRepairs moves is given up on. The result is
+// deterministic for a given seed and safe click; getSeed() on the result
+// still returns the seed, but the layout no longer equals placeBombs(seed).
+class NoGuessGenerator {
+private:
+    int maxRepairs;
+    std::vector<int> stuckMines; // reused between repairs
+    std::vector<int> flaggedMines;
+    std::vector<int> targets;
+    long long repairs;
+
+    bool solve(Field& board);
+    bool repair(Field& board, SplitMix64& random);
+    template <typename Topology>
+    bool repairWith(Field& board, SplitMix64& random);
+
+public:
+    explicit NoGuessGenerator(int repairLimit = 1000);
+
+    // Fills `board` with a no-guess layout of its size and bomb count.
+    // Returns false if the repair limit was hit; try another seed.
+    bool generate(std::uint64_t seed, int safeRow, int safeCol, Field& board);
+
+    long long getRepairs() const; // mines moved so far, over every board
+};
+
+// Ready-to-serve no-guess boards, generated in the background.
+//
+// Worker threads keep the pool topped up to `capacity` boards, each with
+// a safe first click in the middle. Board attempt i uses the seed
+// deriveSeed(masterSeed, i); attempts that fail are skipped. The order in
+// which boards come out depends on thread timing. After failureLimit
+// failed attempts in a row (a bomb count no layout satisfies, say) the
+// pool gives up: the workers stop and take fails once it is empty.
+class NoGuessPool {
+private:
+    int rows;
+    int cols;
+    int bombs;
+    std::uint64_t masterSeed;
+    std::size_t capacity;
+    std::uint64_t failureLimit;
+    std::mutex mutex;
+    std::condition_variable notFull;
+    std::condition_variable notEmpty;
+    std::deque<Field> ready;
+    std::atomic<std::uint64_t> nextAttempt;
+    std::uint64_t failuresInARow;
+    bool exhausted; // failureLimit was reached
+    bool stopping;
+    std::vector<std::thread> workers;
+
+    void work();
+
+public:
+    NoGuessPool(int numRows, int numCols, int numBombs, std::uint64_t seed, std::size_t poolCapacity, int threads = 0,
+                std::uint64_t giveUpAfter = 10000);
+    ~NoGuessPool();
+
+    NoGuessPool(const NoGuessPool&) = delete;
+    NoGuessPool& operator =(const NoGuessPool&) = delete;
+
+    // Block until a board is ready; false if the pool has given up (or,
+    // for takeFor, the timeout passed) with no board left to hand out.
+    bool take(Field& board);
+    bool takeFor(Field& board, std::chrono::milliseconds timeout);
+    bool tryTake(Field& board); // false if the pool is empty right now
+    std::size_t available();
+};
+
+#endif // NOGUESSGENERATOR_H
@@ -0,0 +1,555 @@
+#include "ProbabilityEngine.h"
+#include "FixedField.h"
+#include "Random.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace {
+
+const std::size_t MAX_CACHED_COMPONENTS = 4096;
+
+// Iterative backtracking over the cells of one component. Cells are
+// ordered so that neighbouring cells come one after another, which makes
+// most numbers complete early and prunes dead branches quickly.
+class Enumerator {
+private:
+    int n;
+    const std::vector<std::vector<int>>& varConstraints;
+    const std::vector<int>& targets;
+    std::vector<int> mines;
+    std::vector<int> unassigned;
+    std::vector<int> assignment;
+    int minesCap;
+
+    bool assign(int var, int value) {
+        bool feasible = true;
+        for (int c : varConstraints[var]) {
+            mines[c] += value;
+            --unassigned[c];
+            if (mines[c] > targets[c] || mines[c] + unassigned[c] < targets[c]) {
+                feasible = false;
+            }
+        }
+        return feasible;
+    }
+
+    void unassign(int var, int value) {
+        for (int c : varConstraints[var]) {
+            mines[c] -= value;
+            ++unassigned[c];
+        }
+    }
+
+public:
+    Enumerator(int vars, const std::vector<std::vector<int>>& constraintsOfVar, const std::vector<int>& constraintTargets,
+               const std::vector<int>& constraintSizes, int cap)
+        : n(vars), varConstraints(constraintsOfVar), targets(constraintTargets), mines(constraintTargets.size(), 0),
+          unassigned(constraintSizes), assignment(vars, 0), minesCap(cap) {}
+
+    // Adds every solution (or only the first one when random is set) to
+    // weights and cellMines. Without random, cellMines[v * (n + 1) + m]
+    // counts the solutions with m mines where v is one; with random,
+    // cellMines[2 * v] counts the samples where v is one and
+    // cellMines[2 * v + 1] sums their mine counts. Returns false if
+    // maxNodes ran out first. The counters are left clean either way, so
+    // the enumerator can be run again.
+    bool run(long long maxNodes, SplitMix64* random, std::vector<double>& weights, std::vector<double>& cellMines) {
+        std::vector<signed char> tried(n, 0);
+        std::vector<signed char> firstValue(n, 0);
+        std::vector<char> applied(n, 0);
+        long long nodes = 0;
+        bool complete = true;
+        int total = 0;
+        int var = 0;
+        for (;;) {
+            if (var == n) {
+                weights[total] += 1.0;
+                for (int v = 0; v < n; ++v) {
+                    if (assignment[v] && random) {
+                        cellMines[2 * v] += 1.0;
+                        cellMines[2 * v + 1] += total;
+                    }
+                    else if (assignment[v]) {
+                        cellMines[v * (n + 1) + total] += 1.0;
+                    }
+                }
+                if (random) {
+                    break;
+                }
+                --var;
+            }
+            if (var < 0) {
+                break;
+            }
+            if (applied[var]) {
+                unassign(var, assignment[var]);
+                total -= assignment[var];
+                applied[var] = 0;
+            }
+            if (tried[var] == 2) {
+                tried[var] = 0;
+                --var;
+                continue;
+            }
+            if (++nodes > maxNodes) {
+                complete = false;
+                break;
+            }
+            if (tried[var] == 0) {
+                firstValue[var] = random ? static_cast<signed char>(random->next() & 1) : 0;
+            }
+            int value = firstValue[var] ^ tried[var];
+            ++tried[var];
+            if (total + value > minesCap) {
+                continue;
+            }
+            bool feasible = assign(var, value);
+            assignment[var] = value;
+            applied[var] = 1;
+            total += value;
+            if (feasible) {
+                ++var;
+            }
+        }
+        // Leave the counters clean for the next run.
+        for (int v = 0; v < n; ++v) {
+            if (applied[v]) {
+                unassign(v, assignment[v]);
+            }
+        }
+        return complete;
+    }
+};
+
+std::vector<double> convolve(const std::vector<double>& a, const std::vector<double>& b) {
+    std::vector<double> result(a.size() + b.size() - 1, 0.0);
+    for (std::size_t i = 0; i < a.size(); ++i) {
+        if (a[i] == 0.0) {
+            continue;
+        }
+        for (std::size_t j = 0; j < b.size(); ++j) {
+            result[i + j] += a[i] * b[j];
+        }
+    }
+    return result;
+}
+
+// Rescales v so that its largest entry is 1 and returns log of the factor removed.
+double normalize(std::vector<double>& v) {
+    double largest = *std::max_element(v.begin(), v.end());
+    if (largest <= 0.0) {
+        return 0.0;
+    }
+    for (double& x : v) {
+        x /= largest;
+    }
+    return std::log(largest);
+}
+
+double logChoose(int n, int k) {
+    if (k < 0 || k > n) {
+        return -std::numeric_limits<double>::infinity();
+    }
+    return std::lgamma(n + 1.0) - std::lgamma(k + 1.0) - std::lgamma(n - k + 1.0);
+}
+
+}
+
+ProbabilityEngine::ProbabilityEngine(const ProbabilityBudget& limits)
+    : budget(limits), interiorProbability(0.0), exact(true) {}
+
+ProbabilityBudget ProbabilityEngine::defaultBudget() {
+    return {48, 2000000, 400, 5e7};
+}
+
+template <typename Board>
+void ProbabilityEngine::compute(const Board& field, const std::vector<int>& frontierNumbers, int unknownCells, int minesLeft) {
+    int rows = field.getRows();
+    int cols = field.getCols();
+    cells.clear();
+    probabilities.clear();
+    exact = true;
+
+    // One variable per closed unflagged cell next to a frontier number.
+    std::unordered_map<int, int> varOf;
+    std::vector<int> varCells;
+    std::vector<std::vector<int>> constraintVars;
+    std::vector<int> targets;
+    withTopology(field.getTopology(), [&](auto policy) {
+        for (int number : frontierNumbers) {
+            int row = number / cols;
+            int col = number % cols;
+            int target = field.getCell(row, col).getBombsNearby();
+            std::vector<int> vars;
+            decltype(policy)::forEachNeighbour(row, col, rows, cols, [&](int r, int c) {
+                const Cell& cell = field.getCell(r, c);
+                if (cell.getOpen()) {
+                    return;
+                }
+                if (cell.getFlagged()) {
+                    --target;
+                    return;
+                }
+                int board = r * cols + c;
+                auto found = varOf.find(board);
+                if (found == varOf.end()) {
+                    found = varOf.emplace(board, static_cast<int>(varCells.size())).first;
+                    varCells.push_back(board);
+                }
+                vars.push_back(found->second);
+            });
+            if (!vars.empty()) {
+                constraintVars.push_back(vars);
+                targets.push_back(target);
+            }
+        }
+    });
+
+    // Union-find: cells that share a number belong to the same component.
+    std::vector<int> parent(varCells.size());
+    for (std::size_t i = 0; i < parent.size(); ++i) {
+        parent[i] = static_cast<int>(i);
+    }
+    auto find = [&parent](int x) {
+        while (parent[x] != x) {
+            parent[x] = parent[parent[x]];
+            x = parent[x];
+        }
+        return x;
+    };
+    for (const std::vector<int>& vars : constraintVars) {
+        for (std::size_t i = 1; i < vars.size(); ++i) {
+            parent[find(vars[i])] = find(vars[0]);
+        }
+    }
+
+    std::unordered_map<int, std::vector<int>> constraintsOfRoot;
+    for (std::size_t c = 0; c < constraintVars.size(); ++c) {
+        constraintsOfRoot[find(constraintVars[c][0])].push_back(static_cast<int>(c));
+    }
+
+    std::vector<const Component*> components;
+    if (cache.size() > MAX_CACHED_COMPONENTS) {
+        cache.clear();
+    }
+
+    for (const auto& group : constraintsOfRoot) {
+        // Canonical description of the component: each number as
+        // (target, sorted board cells), the numbers sorted.
+        std::vector<std::vector<int>> described;
+        for (int c : group.second) {
+            std::vector<int> entry(1, targets[c]);
+            for (int var : constraintVars[c]) {
+                entry.push_back(varCells[var]);
+            }
+            std::sort(entry.begin() + 1, entry.end());
+            described.push_back(entry);
+        }
+        std::sort(described.begin(), described.end());
+
+        std::vector<int> local;
+        for (const std::vector<int>& entry : described) {
+            local.insert(local.end(), entry.begin() + 1, entry.end());
+        }
+        std::sort(local.begin(), local.end());
+        local.erase(std::unique(local.begin(), local.end()), local.end());
+        int cap = std::min(minesLeft, static_cast<int>(local.size()));
+
+        std::string key(reinterpret_cast<const char*>(&cap), sizeof(cap));
+        for (const std::vector<int>& entry : described) {
+            int size = static_cast<int>(entry.size());
+            key.append(reinterpret_cast<const char*>(&size), sizeof(size));
+            key.append(reinterpret_cast<const char*>(entry.data()), entry.size() * sizeof(int));
+        }
+
+        auto cached = cache.find(key);
+        if (cached == cache.end()) {
+            std::vector<std::vector<int>> localConstraints;
+            std::vector<int> localTargets;
+            for (const std::vector<int>& entry : described) {
+                std::vector<int> vars;
+                for (std::size_t i = 1; i < entry.size(); ++i) {
+                    vars.push_back(static_cast<int>(std::lower_bound(local.begin(), local.end(), entry[i]) - local.begin()));
+                }
+                localConstraints.push_back(vars);
+                localTargets.push_back(entry[0]);
+            }
+            Component result;
+            solveComponent(local, localConstraints, localTargets, cap, result);
+            cached = cache.emplace(key, result).first;
+        }
+        components.push_back(&cached->second);
+        exact = exact && cached->second.exact;
+    }
+
+    combine(components, unknownCells - static_cast<int>(varCells.size()), minesLeft);
+}
+
+template void ProbabilityEngine::compute(const Field&, const std::vector<int>&, int, int);
+template void ProbabilityEngine::compute(const BeginnerField&, const std::vector<int>&, int, int);
+template void ProbabilityEngine::compute(const IntermediateField&, const std::vector<int>&, int, int);
+template void ProbabilityEngine::compute(const ExpertField&, const std::vector<int>&, int, int);
+
+void ProbabilityEngine::solveComponent(const std::vector<int>& vars, const std::vector<std::vector<int>>& constraintVars,
+                                       const std::vector<int>& targets, int minesLeft, Component& result) const {
+    int n = static_cast<int>(vars.size());
+
+    // Breadth-first order through shared numbers.
+    std::vector<std::vector<int>> constraintsOf(n);
+    for (std::size_t c = 0; c < constraintVars.size(); ++c) {
+        for (int var : constraintVars[c]) {
+            constraintsOf[var].push_back(static_cast<int>(c));
+        }
+    }
+    std::vector<int> order;
+    std::vector<int> position(n, -1);
+    for (int start = 0; start < n; ++start) {
+        if (position[start] >= 0) {
+            continue;
+        }
+        position[start] = static_cast<int>(order.size());
+        order.push_back(start);
+        for (std::size_t head = order.size() - 1; head < order.size(); ++head) {
+            for (int c : constraintsOf[order[head]]) {
+                for (int var : constraintVars[c]) {
+                    if (position[var] < 0) {
+                        position[var] = static_cast<int>(order.size());
+                        order.push_back(var);
+                    }
+                }
+            }
+        }
+    }
+
+    std::vector<std::vector<int>> varConstraints(n);
+    std::vector<int> sizes(constraintVars.size());
+    for (int i = 0; i < n; ++i) {
+        varConstraints[i] = constraintsOf[order[i]];
+    }
+    for (std::size_t c = 0; c < constraintVars.size(); ++c) {
+        sizes[c] = static_cast<int>(constraintVars[c].size());
+    }
+
+    result.cells.resize(n);
+    for (int i = 0; i < n; ++i) {
+        result.cells[i] = vars[order[i]];
+    }
+    result.weights.assign(n + 1, 0.0);
+    result.sampledMines = 0.0;
+    result.exact = false;
+
+    Enumerator enumerator(n, varConstraints, targets, sizes, minesLeft);
+    if (n <= budget.maxExactCells) {
+        result.cellMines.assign(static_cast<std::size_t>(n) * (n + 1), 0.0);
+        result.exact = enumerator.run(budget.maxNodes, nullptr, result.weights, result.cellMines);
+    }
+    if (!result.exact) {
+        // Too big to enumerate: draw random solutions instead, keeping two
+        // sums per cell rather than one per cell and mine count.
+        std::fill(result.weights.begin(), result.weights.end(), 0.0);
+        std::vector<double>().swap(result.cellMines);
+        result.cellMineFit.assign(2 * static_cast<std::size_t>(n), 0.0);
+        SplitMix64 random(static_cast<std::uint64_t>(vars[0]) * 0x9E3779B97F4A7C15ULL + n);
+        long long nodesPerSample = std::max(1000LL, budget.maxNodes / std::max(1, budget.samples));
+        for (int sample = 0; sample < budget.samples; ++sample) {
+            enumerator.run(nodesPerSample, &random, result.weights, result.cellMineFit);
+        }
+    }
+
+    double solutions = 0.0;
+    for (double w : result.weights) {
+        solutions += w;
+    }
+    if (solutions == 0.0) {
+        // No consistent assignment found within the budget: assume nothing.
+        result.weights[n / 2] = 1.0;
+        result.sampledMines = n / 2;
+        for (int i = 0; i < n; ++i) {
+            if (result.exact) {
+                result.cellMines[i * (n + 1) + n / 2] = 0.5;
+            }
+            else {
+                result.cellMineFit[2 * i] = 0.5;
+                result.cellMineFit[2 * i + 1] = 0.0;
+            }
+        }
+        return;
+    }
+
+    if (!result.exact) {
+        // Least-squares line through each cell's mine indicator against the
+        // sample's mine count, so cell probabilities still follow the mine
+        // count the rest of the board favours.
+        double mean = 0.0;
+        for (int m = 0; m <= n; ++m) {
+            mean += m * result.weights[m];
+        }
+        mean /= solutions;
+        double variance = 0.0;
+        for (int m = 0; m <= n; ++m) {
+            variance += (m - mean) * (m - mean) * result.weights[m];
+        }
+        variance /= solutions;
+        result.sampledMines = mean;
+        for (int i = 0; i < n; ++i) {
+            double hit = result.cellMineFit[2 * i] / solutions;
+            double covariance = result.cellMineFit[2 * i + 1] / solutions - hit * mean;
+            result.cellMineFit[2 * i] = hit;
+            result.cellMineFit[2 * i + 1] = variance > 0.0 ? covariance / variance : 0.0;
+        }
+    }
+
+    double largest = *std::max_element(result.weights.begin(), result.weights.end());
+    for (double& w : result.weights) {
+        w /= largest;
+    }
+    for (double& w : result.cellMines) {
+        w /= largest;
+    }
+}
+
+void ProbabilityEngine::combine(const std::vector<const Component*>& components, int interiorCells, int minesLeft) {
+    std::size_t k = components.size();
+    std::size_t frontierCells = 0;
+    for (const Component* component : components) {
+        frontierCells += component->cells.size();
+    }
+    double ops = static_cast<double>(k) * static_cast<double>(frontierCells) * static_cast<double>(frontierCells);
+    int unknownCells = interiorCells + static_cast<int>(frontierCells);
+
+    if (ops > budget.maxCombineOps) {
+        // Too many components to convolve exactly: treat every unknown cell
+        // as a mine with the average density, which weights a component
+        // solution with m mines by (p / (1 - p))^m.
+        exact = false;
+        double density = unknownCells > 0 ? static_cast<double>(minesLeft) / unknownCells : 0.0;
+        density = std::min(std::max(density, 1e-9), 1.0 - 1e-9);
+        double logRatio = std::log(density / (1.0 - density));
+        for (const Component* component : components) {
+            std::size_t n = component->cells.size();
+            std::vector<double> terms(n + 1);
+            for (std::size_t m = 0; m <= n; ++m) {
+                terms[m] = component->weights[m] > 0.0 ? std::log(component->weights[m]) + logRatio * m
+                                                       : -std::numeric_limits<double>::infinity();
+            }
+            double top = *std::max_element(terms.begin(), terms.end());
+            double z = 0.0;
+            for (std::size_t m = 0; m <= n; ++m) {
+                z += std::exp(terms[m] - top);
+            }
+            double spread = 0.0; // sampled: z times the expected distance from the sampled mean
+            for (std::size_t m = 0; m <= n && !component->exact; ++m) {
+                spread += (m - component->sampledMines) * std::exp(terms[m] - top);
+            }
+            for (std::size_t i = 0; i < n; ++i) {
+                double p = 0.0;
+                if (component->exact) {
+                    for (std::size_t m = 0; m <= n; ++m) {
+                        double w = component->cellMines[i * (n + 1) + m];
+                        if (w > 0.0) {
+                            p += w / component->weights[m] * std::exp(terms[m] - top);
+                        }
+                    }
+                }
+                else {
+                    p = component->cellMineFit[2 * i] * z + component->cellMineFit[2 * i + 1] * spread;
+                }
+                cells.push_back(component->cells[i]);
+                probabilities.push_back(std::min(1.0, std::max(0.0, p / z)));
+            }
+        }
+        interiorProbability = density;
+        return;
+    }
+
+    // prefix[i]: convolution of the components before i, suffix[i]: from i on.
+    std::vector<std::vector<double>> prefix(k + 1), suffix(k + 1);
+    std::vector<double> prefixLog(k + 1, 0.0), suffixLog(k + 1, 0.0);
+    prefix[0].assign(1, 1.0);
+    for (std::size_t i = 0; i < k; ++i) {
+        prefix[i + 1] = convolve(prefix[i], components[i]->weights);
+        prefixLog[i + 1] = prefixLog[i] + normalize(prefix[i + 1]);
+    }
+    suffix[k].assign(1, 1.0);
+    for (std::size_t i = k; i-- > 0;) {
+        suffix[i] = convolve(components[i]->weights, suffix[i + 1]);
+        suffixLog[i] = suffixLog[i + 1] + normalize(suffix[i]);
+    }
+
+    // weight[s]: ways to place the remaining mines off the frontier when s are on it.
+    std::vector<double> weight(frontierCells + 1);
+    double topLog = -std::numeric_limits<double>::infinity();
+    for (std::size_t s = 0; s <= frontierCells; ++s) {
+        weight[s] = logChoose(interiorCells, minesLeft - static_cast<int>(s));
+        topLog = std::max(topLog, weight[s]);
+    }
+    for (double& w : weight) {
+        w = std::exp(w - topLog);
+    }
+
+    const std::vector<double>& total = prefix[k];
+    double z = 0.0;
+    double interiorMines = 0.0;
+    for (std::size_t s = 0; s < total.size(); ++s) {
+        z += total[s] * weight[s];
+        interiorMines += total[s] * weight[s] * (minesLeft - static_cast<int>(s));
+    }
+    if (z <= 0.0) {
+        exact = false;
+        z = 1.0;
+    }
+    interiorProbability = interiorCells > 0 ? interiorMines / z / interiorCells : 0.0;
+
+    for (std::size_t i = 0; i < k; ++i) {
+        const Component& component = *components[i];
+        std::size_t n = component.cells.size();
+        std::vector<double> others = convolve(prefix[i], suffix[i + 1]);
+        // Scale of `others` relative to `total`, both measured in normalized units.
+        double scale = std::exp(prefixLog[i] + suffixLog[i + 1] - prefixLog[k]);
+
+        std::vector<double> rest(n + 1, 0.0);
+        for (std::size_t m = 0; m <= n; ++m) {
+            for (std::size_t t = 0; t < others.size() && m + t <= frontierCells; ++t) {
+                rest[m] += others[t] * weight[m + t];
+            }
+        }
+        // Sampled: the weight of the component's solutions, and of their
+        // distance from the sampled mean mine count.
+        double mass = 0.0;
+        double spread = 0.0;
+        for (std::size_t m = 0; m <= n && !component.exact; ++m) {
+            mass += component.weights[m] * rest[m];
+            spread += (m - component.sampledMines) * component.weights[m] * rest[m];
+        }
+        for (std::size_t c = 0; c < n; ++c) {
+            double p = 0.0;
+            if (component.exact) {
+                for (std::size_t m = 0; m <= n; ++m) {
+                    p += component.cellMines[c * (n + 1) + m] * rest[m];
+                }
+            }
+            else {
+                p = component.cellMineFit[2 * c] * mass + component.cellMineFit[2 * c + 1] * spread;
+            }
+            cells.push_back(component.cells[c]);
+            probabilities.push_back(std::min(1.0, std::max(0.0, p * scale / z)));
+        }
+    }
+}
+
+const std::vector<int>& ProbabilityEngine::getCells() const {
+    return cells;
+}
+
+const std::vector<double>& ProbabilityEngine::getProbabilities() const {
+    return probabilities;
+}
+
+double ProbabilityEngine::getInteriorProbability() const {
+    return interiorProbability;
+}
+
+bool ProbabilityEngine::wasExact() const {
+    return exact;
+}
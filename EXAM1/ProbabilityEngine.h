@@ -0,0 +1,64 @@
+#ifndef PROBABILITYENGINE_H
+#define PROBABILITYENGINE_H
+
+#include "Field.h"
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+struct ProbabilityBudget {
+    int maxExactCells;    // bigger components are sampled instead of enumerated
+    long long maxNodes;   // backtracking nodes per component before falling back to sampling
+    int samples;          // solutions drawn for a sampled component
+    double maxCombineOps; // above this the global bomb count is only approximated
+};
+
+// Exact mine probabilities for the closed cells next to the frontier.
+//
+// The unknown cells around the frontier numbers are split into independent
+// components (cells linked through a shared number). Every component is
+// enumerated by backtracking, counting its solutions per number of mines,
+// and the results are memoized so unchanged components are not enumerated
+// again on the next move. The components are then combined with the number
+// of mines left on the board: a split that puts s mines on the frontier is
+// weighted by C(interior cells, minesLeft - s).
+class ProbabilityEngine {
+private:
+    struct Component {
+        std::vector<int> cells;       // board indices
+        std::vector<double> weights;  // weights[m]: solutions with m mines (scaled)
+        std::vector<double> cellMines; // exact: [cell * (cells.size() + 1) + m], solutions where that cell is a mine
+        std::vector<double> cellMineFit; // sampled: [2 * cell] mine frequency, [2 * cell + 1] its slope in m
+        double sampledMines;             // sampled: mean mine count of the samples
+        bool exact;
+    };
+
+    ProbabilityBudget budget;
+    std::vector<int> cells;
+    std::vector<double> probabilities;
+    double interiorProbability;
+    bool exact;
+    std::unordered_map<std::string, Component> cache;
+
+    void solveComponent(const std::vector<int>& vars, const std::vector<std::vector<int>>& constraintVars,
+                        const std::vector<int>& targets, int minesLeft, Component& result) const;
+    void combine(const std::vector<const Component*>& components, int interiorCells, int minesLeft);
+
+public:
+    explicit ProbabilityEngine(const ProbabilityBudget& limits = defaultBudget());
+
+    static ProbabilityBudget defaultBudget();
+
+    // frontierNumbers are board indices of open numbers with closed neighbours,
+    // unknownCells counts closed unflagged cells, flags are taken as mines.
+    // Board is Field or one of the FixedField presets.
+    template <typename Board>
+    void compute(const Board& field, const std::vector<int>& frontierNumbers, int unknownCells, int minesLeft);
+
+    const std::vector<int>& getCells() const;
+    const std::vector<double>& getProbabilities() const; // parallel to getCells()
+    double getInteriorProbability() const;               // for cells away from every number
+    bool wasExact() const;                               // false if sampling or approximation was used
+};
+
+#endif // PROBABILITYENGINE_H
@@ -0,0 +1,105 @@
+#ifndef RANDOM_H
+#define RANDOM_H
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+// SplitMix64: small, fast and fully specified, so the same seed gives the
+// same board with any compiler and standard library (unlike std::mt19937
+// combined with std::uniform_int_distribution).
+class SplitMix64 {
+private:
+    std::uint64_t state;
+
+public:
+    explicit SplitMix64(std::uint64_t seed) : state(seed) {}
+
+    std::uint64_t next() {
+        std::uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        return z ^ (z >> 31);
+    }
+
+    // Uniform value in [0, bound), without modulo bias.
+    std::uint64_t nextBelow(std::uint64_t bound) {
+        std::uint64_t threshold = (0 - bound) % bound;
+        for (;;) {
+            std::uint64_t value = next();
+            if (value >= threshold) {
+                return value % bound;
+            }
+        }
+    }
+};
+
+// Seed of an independent stream (a game, a thread, a chunk) derived from one master seed.
+inline std::uint64_t deriveSeed(std::uint64_t master, std::uint64_t stream) {
+    SplitMix64 mixer(master ^ (stream * 0xD1B54A32D192ED03ULL));
+    mixer.next();
+    return mixer.next();
+}
+
+// How many of `marked` items out of `population` land in a uniform sample
+// of `draws` items (the hypergeometric distribution): the exact way to
+// split a bomb count between two parts of a board. The weights are walked
+// outwards from the mode with the ratio of consecutive terms, so no
+// factorials are needed; the walk stops where a term drops below 1e-17 of
+// the mode's, and costs O(standard deviation).
+inline std::uint64_t sampleHypergeometric(SplitMix64& random, std::uint64_t population, std::uint64_t marked,
+                                          std::uint64_t draws) {
+    marked = std::min(marked, population);
+    draws = std::min(draws, population);
+    std::uint64_t low = draws + marked > population ? draws + marked - population : 0;
+    std::uint64_t high = std::min(draws, marked);
+    if (low == high) {
+        return low;
+    }
+
+    double n = static_cast<double>(draws);
+    double k = static_cast<double>(marked);
+    double rest = static_cast<double>(population - marked);
+    std::uint64_t mode = static_cast<std::uint64_t>((n + 1.0) * (k + 1.0) / (static_cast<double>(population) + 2.0));
+    mode = std::min(std::max(mode, low), high);
+
+    // w(x + 1) / w(x) = (k - x)(n - x) / ((x + 1)(rest - n + x + 1))
+    std::vector<double> below; // w(mode - 1), w(mode - 2), ...
+    std::vector<double> above; // w(mode + 1), w(mode + 2), ...
+    double total = 1.0;
+    double weight = 1.0;
+    for (std::uint64_t x = mode; x > low && weight > 1e-17; --x) {
+        double y = static_cast<double>(x - 1);
+        weight *= (y + 1.0) * (rest - n + y + 1.0) / ((k - y) * (n - y));
+        below.push_back(weight);
+        total += weight;
+    }
+    weight = 1.0;
+    for (std::uint64_t x = mode; x < high && weight > 1e-17; ++x) {
+        double y = static_cast<double>(x);
+        weight *= (k - y) * (n - y) / ((y + 1.0) * (rest - n + y + 1.0));
+        above.push_back(weight);
+        total += weight;
+    }
+
+    double target = static_cast<double>(random.next() >> 11) * (1.0 / 9007199254740992.0) * total;
+    for (std::size_t i = below.size(); i-- > 0;) {
+        if (target < below[i]) {
+            return mode - 1 - i;
+        }
+        target -= below[i];
+    }
+    if (target < 1.0) {
+        return mode;
+    }
+    target -= 1.0;
+    for (std::size_t i = 0; i < above.size(); ++i) {
+        if (target < above[i]) {
+            return mode + 1 + i;
+        }
+        target -= above[i];
+    }
+    return mode + above.size(); // rounding left target just past the last term
+}
+
+#endif // RANDOM_H
@@ -0,0 +1,117 @@
+#include "Renderer.h"
+
+char cellGlyph(const Cell& cell, bool showBombs) {
+    if (cell.getOpen()) {
+        return cell.getBomb() ? '*' : static_cast<char>('0' + cell.getBombsNearby());
+    }
+    if (cell.getFlagged()) {
+        return 'F';
+    }
+    return showBombs && cell.getBomb() ? '*' : '.';
+}
+
+void renderField(const Field& field, bool showBombs, std::string& out) {
+    int rows = field.getRows();
+    int cols = field.getCols();
+    out.reserve(out.size() + static_cast<std::size_t>(rows) * (2 * cols + 1));
+    for (int i = 0; i < rows; ++i) {
+        for (int j = 0; j < cols; ++j) {
+            out += cellGlyph(field.getCell(i, j), showBombs);
+            out += ' ';
+        }
+        out += '\n';
+    }
+}
+
+FieldRenderer::FieldRenderer(std::FILE* stream) : out(stream), rows(0), cols(0) {}
+
+// Terminal rows and columns are 1-based, every cell takes two columns.
+void FieldRenderer::appendCursor(int row, int col) {
+    frame += "\x1b[";
+    frame += std::to_string(row + 1);
+    frame += ';';
+    frame += std::to_string(2 * col + 1);
+    frame += 'H';
+}
+
+// Cells drawn before the first full frame are not tracked.
+void FieldRenderer::remember(int row, int col, char glyph) {
+    if (row < rows && col < cols) {
+        shown[static_cast<std::size_t>(row) * cols + col] = glyph;
+    }
+}
+
+void FieldRenderer::flush() {
+    std::fwrite(frame.data(), 1, frame.size(), out);
+    std::fflush(out);
+}
+
+void FieldRenderer::drawFull(const Field& field, bool showBombs) {
+    rows = field.getRows();
+    cols = field.getCols();
+    frame.assign("\x1b[H\x1b[2J");
+    std::size_t start = frame.size();
+    renderField(field, showBombs, frame);
+    // Every cell is "X " and every row ends in '\n'.
+    shown.resize(static_cast<std::size_t>(rows) * cols);
+    for (int i = 0; i < rows; ++i) {
+        const char* line = frame.data() + start + static_cast<std::size_t>(i) * (2 * cols + 1);
+        for (int j = 0; j < cols; ++j) {
+            shown[static_cast<std::size_t>(i) * cols + j] = line[2 * j];
+        }
+    }
+    flush();
+}
+
+void FieldRenderer::drawChanges(const Field& field, const std::vector<RevealedSpan>& spans, bool showBombs) {
+    frame.clear();
+    for (const RevealedSpan& span : spans) {
+        appendCursor(span.row, span.firstCol);
+        for (int col = span.firstCol; col <= span.lastCol; ++col) {
+            char glyph = cellGlyph(field.getCell(span.row, col), showBombs);
+            remember(span.row, col, glyph);
+            frame += glyph;
+            frame += ' ';
+        }
+    }
+    appendCursor(rows, 0); // park the cursor under the board
+    flush();
+}
+
+void FieldRenderer::drawCell(const Field& field, int row, int col, bool showBombs) {
+    frame.clear();
+    appendCursor(row, col);
+    char glyph = cellGlyph(field.getCell(row, col), showBombs);
+    remember(row, col, glyph);
+    frame += glyph;
+    appendCursor(rows, 0);
+    flush();
+}
+
+void FieldRenderer::drawUpdate(const Field& field, bool showBombs) {
+    if (field.getRows() != rows || field.getCols() != cols) {
+        drawFull(field, showBombs);
+        return;
+    }
+    frame.clear();
+    for (int i = 0; i < rows; ++i) {
+        bool inRun = false; // the cursor already sits on this cell
+        for (int j = 0; j < cols; ++j) {
+            char glyph = cellGlyph(field.getCell(i, j), showBombs);
+            char& old = shown[static_cast<std::size_t>(i) * cols + j];
+            if (glyph == old) {
+                inRun = false;
+                continue;
+            }
+            if (!inRun) {
+                appendCursor(i, j);
+                inRun = true;
+            }
+            frame += glyph;
+            frame += ' ';
+            old = glyph;
+        }
+    }
+    appendCursor(rows, 0);
+    flush();
+}
@@ -0,0 +1,45 @@
+#ifndef RENDERER_H
+#define RENDERER_H
+
+#include "Field.h"
+#include <cstdio>
+#include <string>
+#include <vector>
+
+// The character a cell is drawn with: digit, '*', 'F' or '.'.
+char cellGlyph(const Cell& cell, bool showBombs);
+
+// Appends the text of the whole board ("X " per cell, one line per row) to out.
+void renderField(const Field& field, bool showBombs, std::string& out);
+
+// Draws a Field on an ANSI terminal. Every frame is built in one reusable
+// buffer and handed to the stream with a single fwrite, so a frame costs
+// one write(2) instead of two stream insertions per cell. After a full
+// frame, drawChanges repaints only the cells listed in a reveal (plus any
+// single cells passed to drawCell) using cursor positioning; drawUpdate
+// finds the changed cells itself by comparing with what it last drew.
+class FieldRenderer {
+private:
+    std::FILE* out;
+    std::string frame;
+    std::string shown; // glyph of every cell as it is on screen now, row-major
+    int rows;
+    int cols;
+
+    void appendCursor(int row, int col);
+    void remember(int row, int col, char glyph);
+    void flush();
+
+public:
+    explicit FieldRenderer(std::FILE* stream = stdout);
+
+    void drawFull(const Field& field, bool showBombs);
+    void drawChanges(const Field& field, const std::vector<RevealedSpan>& spans, bool showBombs);
+    void drawCell(const Field& field, int row, int col, bool showBombs);
+    // Repaints every cell whose glyph differs from what is on screen, so
+    // flags are picked up too; the first call (or one for a board of
+    // another size) draws the full frame.
+    void drawUpdate(const Field& field, bool showBombs);
+};
+
+#endif // RENDERER_H
@@ -0,0 +1,325 @@
+#include "SessionManager.h"
+#include "Random.h"
+#include <algorithm>
+#include <cstdint>
+#include <utility>
+
+// Threads blocked in CommandResult::wait park on one of these, picked by
+// the result's address, so a result carries no mutex of its own. The
+// counts live here rather than in the result: the caller may free a
+// result as soon as it sees it ready, before the worker is done waking.
+namespace {
+
+struct ParkingSpot {
+    std::mutex mutex;
+    std::condition_variable changed;
+    std::atomic<int> waiters{0};
+};
+
+ParkingSpot parkingSpots[64];
+
+ParkingSpot& parkingSpot(const CommandResult* result) {
+    return parkingSpots[(reinterpret_cast<std::uintptr_t>(result) / alignof(CommandResult)) % 64];
+}
+
+// The done store and the waiters load (like the waiter's increment and its
+// ready check) are sequentially consistent, so either the worker sees the
+// waiter or the waiter sees the result.
+void publish(CommandResult& result) {
+    ParkingSpot& spot = parkingSpot(&result);
+    result.done.store(true, std::memory_order_seq_cst);
+    if (spot.waiters.load(std::memory_order_seq_cst) > 0) {
+        std::lock_guard<std::mutex> lock(spot.mutex);
+        spot.changed.notify_all();
+    }
+}
+
+}
+
+void CommandResult::wait() const {
+    if (ready()) {
+        return;
+    }
+    ParkingSpot& spot = parkingSpot(this);
+    std::unique_lock<std::mutex> lock(spot.mutex);
+    spot.waiters.fetch_add(1, std::memory_order_seq_cst);
+    spot.changed.wait(lock, [this] { return done.load(std::memory_order_seq_cst); });
+    spot.waiters.fetch_sub(1, std::memory_order_relaxed);
+}
+
+// Completes a command that was not applied.
+static void skip(CommandResult& result, SessionState state) {
+    result.status = OpenStatus();
+    result.status.bombRow = -1;
+    result.status.bombCol = -1;
+    result.state = state;
+    result.applied = false;
+    publish(result);
+}
+
+std::unique_ptr<Field> BoardPool::acquire(int rows, int cols, int bombs) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        std::vector<std::unique_ptr<Field>>& boards = freeBoards[std::make_tuple(rows, cols, bombs)];
+        if (!boards.empty()) {
+            std::unique_ptr<Field> board = std::move(boards.back());
+            boards.pop_back();
+            return board;
+        }
+    }
+    return std::unique_ptr<Field>(new Field(rows, cols, bombs));
+}
+
+void BoardPool::release(std::unique_ptr<Field> board) {
+    std::lock_guard<std::mutex> lock(mutex);
+    freeBoards[std::make_tuple(board->getRows(), board->getCols(), board->getTotalBombs())].push_back(std::move(board));
+}
+
+SessionManager::SessionManager(std::size_t maxSessions, int threads, std::size_t commandsPerBatch)
+    : sessions(new Session[maxSessions]), capacity(maxSessions), created(0),
+      batchSize(std::max<std::size_t>(commandsPerBatch, 1)), stopping(false) {
+    for (std::size_t i = 0; i < capacity; ++i) {
+        sessions[i].scheduled = false;
+        sessions[i].closed = true;
+        sessions[i].seed = 0;
+        sessions[i].games = 0;
+        sessions[i].placed = false;
+        sessions[i].generation = 0;
+    }
+    if (threads <= 0) {
+        threads = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+    }
+    for (int i = 0; i < threads; ++i) {
+        workers.emplace_back(&SessionManager::work, this);
+    }
+}
+
+SessionManager::~SessionManager() {
+    {
+        std::lock_guard<std::mutex> lock(readyMutex);
+        stopping = true;
+    }
+    readyChanged.notify_all();
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+    std::size_t used = std::min(created.load(), capacity);
+    for (std::size_t i = 0; i < used; ++i) {
+        for (const Pending& pending : sessions[i].queue) {
+            skip(*pending.result, SESSION_PLAYING);
+        }
+        sessions[i].queue.clear();
+    }
+}
+
+SessionManager::SessionId SessionManager::createSession(int rows, int cols, int bombs, std::uint64_t seed) {
+    std::size_t id;
+    {
+        std::lock_guard<std::mutex> lock(slotMutex);
+        if (!freeSlots.empty()) {
+            id = freeSlots.back();
+            freeSlots.pop_back();
+        }
+        else {
+            id = created.load();
+            if (id >= capacity) {
+                return static_cast<SessionId>(-1);
+            }
+            created.store(id + 1);
+        }
+    }
+    Session& session = sessions[id];
+    std::lock_guard<std::mutex> lock(session.mutex);
+    session.board = pool.acquire(rows, cols, bombs);
+    session.seed = seed;
+    session.games = 0;
+    session.placed = false;
+    session.closed = false;
+    ++session.generation;
+    return static_cast<SessionId>(session.generation) << 32 | id;
+}
+
+SessionManager::Session* SessionManager::find(SessionId id) const {
+    std::size_t slot = static_cast<std::size_t>(id & 0xFFFFFFFFu);
+    if (slot >= created.load() || slot >= capacity) {
+        return nullptr;
+    }
+    return &sessions[slot];
+}
+
+bool SessionManager::submit(SessionId id, const SessionCommand& command, CommandResult& result) {
+    Session* found = find(id);
+    if (!found) {
+        return false;
+    }
+    Session& session = *found;
+    bool wake;
+    {
+        std::lock_guard<std::mutex> lock(session.mutex);
+        if (session.generation != static_cast<std::uint32_t>(id >> 32)) {
+            return false;
+        }
+        if (session.closed) {
+            skip(result, SESSION_LOST);
+            return true;
+        }
+        session.queue.push_back({command, &result});
+        wake = !session.scheduled;
+        session.scheduled = true;
+    }
+    if (wake) {
+        schedule(session);
+    }
+    return true;
+}
+
+void SessionManager::closeSession(SessionId id) {
+    Session* found = find(id);
+    if (!found) {
+        return;
+    }
+    Session& session = *found;
+    bool wake;
+    {
+        std::lock_guard<std::mutex> lock(session.mutex);
+        if (session.generation != static_cast<std::uint32_t>(id >> 32) || session.closed) {
+            return;
+        }
+        session.closed = true; // commands queued before this still run; the board is released after them
+        wake = !session.scheduled;
+        session.scheduled = true;
+    }
+    if (wake) {
+        schedule(session);
+    }
+}
+
+std::size_t SessionManager::getSessionCount() const {
+    std::lock_guard<std::mutex> lock(slotMutex);
+    return created.load() - freeSlots.size();
+}
+
+void SessionManager::schedule(Session& session) {
+    {
+        std::lock_guard<std::mutex> lock(readyMutex);
+        ready.push_back(&session);
+    }
+    readyChanged.notify_one();
+}
+
+// A worker owns a scheduled session until it either finds its queue empty
+// (and unschedules it) or puts it back at the end of the ready queue, so
+// a session with a long queue cannot starve the others.
+void SessionManager::work() {
+    std::vector<Pending> batch;
+    for (;;) {
+        Session* session;
+        {
+            std::unique_lock<std::mutex> lock(readyMutex);
+            readyChanged.wait(lock, [this] { return stopping || !ready.empty(); });
+            if (stopping) {
+                return;
+            }
+            session = ready.front();
+            ready.pop_front();
+        }
+
+        batch.clear();
+        {
+            std::lock_guard<std::mutex> lock(session->mutex);
+            std::size_t take = std::min(batchSize, session->queue.size());
+            batch.assign(session->queue.begin(), session->queue.begin() + take);
+            session->queue.erase(session->queue.begin(), session->queue.begin() + take);
+        }
+
+        for (const Pending& pending : batch) {
+            apply(*session, pending.command, *pending.result);
+        }
+
+        bool more;
+        bool released = false;
+        {
+            std::lock_guard<std::mutex> lock(session->mutex);
+            if (session->closed && session->queue.empty() && session->board) {
+                pool.release(std::move(session->board));
+                released = true;
+            }
+            more = !session->queue.empty();
+            session->scheduled = more;
+        }
+        if (released) {
+            std::lock_guard<std::mutex> lock(slotMutex);
+            freeSlots.push_back(static_cast<std::size_t>(session - sessions.get()));
+        }
+        if (more) {
+            schedule(*session);
+        }
+    }
+}
+
+void SessionManager::apply(Session& session, const SessionCommand& command, CommandResult& result) {
+    result.status = OpenStatus();
+    result.status.bombRow = -1;
+    result.status.bombCol = -1;
+    result.applied = false;
+
+    Field* board = session.board.get();
+    if (!board) {
+        skip(result, SESSION_LOST);
+        return;
+    }
+    bool over = board->isExploded() || (session.placed && board->checkWin());
+    bool inside = command.row >= 0 && command.row < board->getRows() && command.col >= 0 && command.col < board->getCols();
+
+    if (command.action == SESSION_RESTART) {
+        ++session.games;
+        session.placed = false;
+        board->resetPlay();
+        result.applied = true;
+    }
+    else if (!over && inside) {
+        if (command.action == SESSION_OPEN) {
+            if (!session.placed) {
+                // Placing resets every cell, so flags set before the first open are put back
+                std::vector<std::pair<int, int>> flags;
+                for (int r = 0; r < board->getRows(); ++r) {
+                    for (int c = 0; c < board->getCols(); ++c) {
+                        if (board->getCell(r, c).getFlagged()) {
+                            flags.emplace_back(r, c);
+                        }
+                    }
+                }
+                board->placeBombs(deriveSeed(session.seed, session.games), command.row, command.col);
+                board->calculateBombsNearby();
+                for (const std::pair<int, int>& flag : flags) {
+                    board->flagCell(flag.first, flag.second);
+                }
+                session.placed = true;
+            }
+            std::pair<int, int> cell(command.row, command.col);
+            result.status = board->openCells(&cell, 1);
+            result.applied = true;
+        }
+        else if (command.action == SESSION_FLAG) {
+            if (!board->getCell(command.row, command.col).getOpen()) {
+                board->flagCell(command.row, command.col);
+                result.applied = true;
+            }
+        }
+        else if (command.action == SESSION_CHORD && session.placed) {
+            result.status = board->chord(command.row, command.col);
+            result.applied = !result.status.refused;
+        }
+    }
+
+    if (board->isExploded()) {
+        result.state = SESSION_LOST;
+    }
+    else if (session.placed && board->checkWin()) {
+        result.state = SESSION_WON;
+    }
+    else {
+        result.state = SESSION_PLAYING;
+    }
+    publish(result);
+}
@@ -0,0 +1,128 @@
+#ifndef SESSIONMANAGER_H
+#define SESSIONMANAGER_H
+
+#include "Field.h"
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+enum SessionAction : unsigned char { SESSION_OPEN, SESSION_FLAG, SESSION_CHORD, SESSION_RESTART };
+
+enum SessionState : unsigned char { SESSION_PLAYING, SESSION_WON, SESSION_LOST };
+
+struct SessionCommand {
+    SessionAction action;
+    int row;
+    int col;
+};
+
+// Filled in by a worker thread. The caller owns it and must keep it alive
+// until ready() is true. The worker publishes it with one store, and only
+// takes a lock to wake a thread blocked in wait(); pollers never cost it one.
+struct CommandResult {
+    OpenStatus status;
+    SessionState state;
+    bool applied; // false if the session was closed, the manager shut down or the game was already over
+    std::atomic<bool> done;
+
+    CommandResult() : status(), state(SESSION_PLAYING), applied(false), done(false) {}
+
+    bool ready() const { return done.load(std::memory_order_acquire); }
+    void wait() const; // blocks (without spinning) until ready()
+    void reset() { done.store(false, std::memory_order_relaxed); } // before submitting it again
+};
+
+// Fields by size, handed out again when a session closes, so a busy
+// service does not keep allocating and freeing boards.
+class BoardPool {
+private:
+    std::mutex mutex;
+    std::map<std::tuple<int, int, int>, std::vector<std::unique_ptr<Field>>> freeBoards;
+
+public:
+    std::unique_ptr<Field> acquire(int rows, int cols, int bombs);
+    void release(std::unique_ptr<Field> board);
+};
+
+// Hosts many concurrent games. Every session has its own command queue;
+// a session with pending commands is scheduled once on a shared ready
+// queue, and a worker of the fixed pool takes it and applies everything
+// queued for it (up to batchSize commands) under one lock round trip.
+// Commands of one session are applied in order and by one thread at a
+// time; different sessions run in parallel. Boards are generated around
+// the first opened cell, like a manual game, and come from a BoardPool.
+// Once a closed session has released its board its slot is handed to the
+// next createSession. An id is the slot in its low 32 bits and the slot's
+// generation in its high 32 bits, so an id kept after its session closed
+// never reaches the session that reuses the slot.
+class SessionManager {
+public:
+    typedef std::uint64_t SessionId;
+
+private:
+    struct Pending {
+        SessionCommand command;
+        CommandResult* result;
+    };
+
+    struct Session {
+        std::mutex mutex;
+        std::vector<Pending> queue;
+        bool scheduled; // on the ready queue or being processed
+        bool closed;
+        std::unique_ptr<Field> board;
+        std::uint64_t seed;
+        std::uint64_t games;
+        bool placed; // bombs are placed on the first open of each game
+        std::uint32_t generation; // bumped every time the slot is handed out
+    };
+
+    std::unique_ptr<Session[]> sessions; // fixed capacity, so lookups need no lock
+    std::size_t capacity;
+    std::atomic<std::size_t> created;
+    mutable std::mutex slotMutex;
+    std::vector<std::size_t> freeSlots; // closed sessions whose board went back to the pool
+    std::size_t batchSize;
+    BoardPool pool;
+
+    std::mutex readyMutex;
+    std::condition_variable readyChanged;
+    std::deque<Session*> ready;
+    bool stopping;
+    std::vector<std::thread> workers;
+
+    Session* find(SessionId id) const; // the id's slot, or null if the slot was never handed out
+    void schedule(Session& session);
+    void work();
+    void apply(Session& session, const SessionCommand& command, CommandResult& result);
+
+public:
+    SessionManager(std::size_t maxSessions, int threads = 0, std::size_t commandsPerBatch = 64);
+    // Commands still queued complete with applied == false, so no caller is
+    // left waiting on them.
+    ~SessionManager();
+
+    SessionManager(const SessionManager&) = delete;
+    SessionManager& operator =(const SessionManager&) = delete;
+
+    // Returns a new session id, or -1 (as SessionId) when maxSessions sessions are open.
+    SessionId createSession(int rows, int cols, int bombs, std::uint64_t seed);
+    // Queues a command; `result` is filled in asynchronously. Returns false
+    // (and leaves result untouched) for an unknown id, including the id of
+    // a closed session whose slot has been reused. A command for a closed
+    // session is otherwise completed at once with applied == false.
+    bool submit(SessionId id, const SessionCommand& command, CommandResult& result);
+    // Queued behind the session's pending commands; its board goes back to the pool.
+    void closeSession(SessionId id);
+
+    std::size_t getSessionCount() const; // open sessions
+};
+
+#endif // SESSIONMANAGER_H
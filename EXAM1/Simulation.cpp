@@ -0,0 +1,109 @@
+#include "Simulation.h"
+#include "FieldStats.h"
+#include "FixedField.h"
+#include <chrono>
+
+SimulationStats::SimulationStats() : games(0), wins(0), moves(0), guesses(0), seconds(0.0) {}
+
+void SimulationStats::add(const GameResult& result) {
+    ++games;
+    wins += result.won ? 1 : 0;
+    moves += result.moves;
+    guesses += result.guesses;
+    seconds += result.seconds;
+}
+
+void SimulationStats::merge(const SimulationStats& other) {
+    games += other.games;
+    wins += other.wins;
+    moves += other.moves;
+    guesses += other.guesses;
+    seconds += other.seconds;
+}
+
+double SimulationStats::winRate() const {
+    return games > 0 ? static_cast<double>(wins) / games : 0.0;
+}
+
+double SimulationStats::movesPerGame() const {
+    return games > 0 ? static_cast<double>(moves) / games : 0.0;
+}
+
+double SimulationStats::guessesPerGame() const {
+    return games > 0 ? static_cast<double>(guesses) / games : 0.0;
+}
+
+double SimulationStats::secondsPerGame() const {
+    return games > 0 ? seconds / games : 0.0;
+}
+
+namespace {
+
+// The loop of playGame for any board the solver takes; onMove(field, move)
+// is called after every move.
+template <typename Board, typename OnMove>
+GameResult runGame(Board& field, OnMove onMove) {
+    auto start = std::chrono::steady_clock::now();
+    GameResult result = {false, 0, 0, 0.0};
+
+    BasicSolver<Board> solver(field);
+    for (;;) {
+        Move move;
+        {
+            // A move is the decision plus the reveal, without the observer.
+            FIELD_STATS_MOVE_SCOPE();
+            move = solver.nextMove();
+            if (move.row != -1) {
+                field.openCell(move.row, move.col);
+                solver.onCellsRevealed(field.getLastRevealed());
+            }
+        }
+        if (move.row == -1) {
+            break;
+        }
+        ++result.moves;
+        result.guesses += move.guess ? 1 : 0;
+
+        onMove(field, move);
+        if (field.isExploded()) {
+            break;
+        }
+        if (field.checkWin()) {
+            result.won = true;
+            break;
+        }
+    }
+
+    result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return result;
+}
+
+}
+
+GameResult playGame(Field& field, GameObserver* observer) {
+    return runGame(field, [observer](const Field& board, const Move& move) {
+        if (observer) {
+            observer->onMove(board, move);
+        }
+    });
+}
+
+template <int R, int C>
+GameResult playGame(FixedField<R, C>& field) {
+    return runGame(field, [](const FixedField<R, C>&, const Move&) {});
+}
+
+template GameResult playGame(BeginnerField& field);
+template GameResult playGame(IntermediateField& field);
+template GameResult playGame(ExpertField& field);
+
+SimulationStats simulateGames(int rows, int cols, int bombs, std::uint64_t firstSeed, int games) {
+    SimulationStats stats;
+    Field field(rows, cols, bombs); // placeBombs resets the board, so one allocation serves every game
+    for (int game = 0; game < games; ++game) {
+        field.placeBombs(firstSeed + game, rows / 2, cols / 2);
+        field.calculateBombsNearby();
+        stats.add(playGame(field));
+    }
+    return stats;
+}
@@ -0,0 +1,54 @@
+#ifndef SIMULATION_H
+#define SIMULATION_H
+
+#include "Field.h"
+#include "Solver.h"
+#include <cstdint>
+
+struct GameResult {
+    bool won;
+    int moves;
+    int guesses;
+    double seconds;
+};
+
+struct SimulationStats {
+    long long games;
+    long long wins;
+    long long moves;
+    long long guesses;
+    double seconds;
+
+    SimulationStats();
+
+    void add(const GameResult& result);
+    void merge(const SimulationStats& other);
+
+    double winRate() const;
+    double movesPerGame() const;
+    double guessesPerGame() const;
+    double secondsPerGame() const;
+};
+
+// Lets a front-end watch a game; playGame itself does no console I/O.
+class GameObserver {
+public:
+    virtual ~GameObserver() {}
+    virtual void onMove(const Field& field, const Move& move) = 0;
+};
+
+// Plays the field with the solver until it is won, lost or stuck.
+GameResult playGame(Field& field, GameObserver* observer = nullptr);
+
+// The same game on a compile-time sized board; Simulation.cpp provides the
+// three presets of FixedField.h.
+template <int R, int C>
+class FixedField;
+template <int R, int C>
+GameResult playGame(FixedField<R, C>& field);
+
+// Plays `games` boards of the given size generated from seeds
+// firstSeed, firstSeed + 1, ... with a safe first click in the middle.
+SimulationStats simulateGames(int rows, int cols, int bombs, std::uint64_t firstSeed, int games);
+
+#endif // SIMULATION_H
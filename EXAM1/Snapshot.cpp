@@ -0,0 +1,147 @@
+#include "Snapshot.h"
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+
+namespace {
+
+const char MAGIC[8] = {'M', 'I', 'N', 'E', 'S', 'N', 'A', 'P'};
+
+}
+
+SnapshotHeader Snapshot::headerOf(const Field& field) {
+    SnapshotHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = VERSION;
+    header.cellsOffset = CELLS_OFFSET;
+    header.rows = field.rows;
+    header.cols = field.cols;
+    header.totalBombs = field.totalBombs;
+    header.openedCells = field.openedCells;
+    header.seed = field.seed;
+    header.safeRow = field.safeRow;
+    header.safeCol = field.safeCol;
+    header.exploded = field.exploded ? 1 : 0;
+    header.topology = field.topology;
+    header.placement = field.placement;
+    return header;
+}
+
+bool Snapshot::write(const std::string& path, const SnapshotHeader& header, const void* cells, std::size_t size) {
+    std::string temporary = path + ".tmp";
+    std::FILE* file = std::fopen(temporary.c_str(), "wb");
+    if (!file) {
+        return false;
+    }
+    std::vector<char> page(CELLS_OFFSET, 0);
+    std::memcpy(page.data(), &header, sizeof(header));
+    bool ok = std::fwrite(page.data(), 1, page.size(), file) == page.size() &&
+              std::fwrite(cells, 1, size, file) == size;
+    ok = (std::fclose(file) == 0) && ok;
+    if (!ok || std::rename(temporary.c_str(), path.c_str()) != 0) {
+        std::remove(temporary.c_str());
+        return false;
+    }
+    return true;
+}
+
+bool Snapshot::save(const Field& field, const std::string& path) {
+    return write(path, headerOf(field), field.cells.data(), field.cells.size());
+}
+
+Field Snapshot::load(const std::string& path) {
+    std::FILE* file = std::fopen(path.c_str(), "rb");
+    if (!file) {
+        throw std::runtime_error("Cannot open snapshot: " + path);
+    }
+    SnapshotHeader header;
+    bool read = std::fread(&header, sizeof(header), 1, file) == 1;
+    std::fseek(file, 0, SEEK_END);
+    long fileSize = std::ftell(file);
+    std::fclose(file);
+
+    if (!read || std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0) {
+        throw std::runtime_error("Not a minesweeper snapshot: " + path);
+    }
+    if (header.version != VERSION) {
+        throw std::runtime_error("Unsupported snapshot version: " + path);
+    }
+    if (header.topology > TOPOLOGY_HEX) {
+        throw std::runtime_error("Unsupported snapshot topology: " + path);
+    }
+    if (header.placement > PLACEMENT_PARALLEL) {
+        throw std::runtime_error("Unsupported snapshot placement: " + path);
+    }
+    std::size_t size = static_cast<std::size_t>(header.rows) * static_cast<std::size_t>(header.cols);
+    if (header.rows < 0 || header.cols < 0 || fileSize < 0 ||
+        static_cast<std::size_t>(fileSize) < header.cellsOffset + size) {
+        throw std::runtime_error("Truncated snapshot: " + path);
+    }
+    if (header.openedCells < 0 || static_cast<unsigned long long>(header.openedCells) > size) {
+        throw std::runtime_error("Corrupt snapshot: " + path);
+    }
+
+    Field field(header.rows, header.cols, header.totalBombs, static_cast<TopologyKind>(header.topology),
+                CellStorage::mapFile(path, header.cellsOffset, size));
+    field.openedCells = header.openedCells;
+    field.seed = header.seed;
+    field.safeRow = header.safeRow;
+    field.safeCol = header.safeCol;
+    field.placement = static_cast<BombPlacement>(header.placement);
+    field.exploded = header.exploded != 0;
+    return field;
+}
+
+SnapshotWriter::SnapshotWriter(const std::string& snapshotPath)
+    : path(snapshotPath), pending(false), writing(false), stopping(false), lastResult(true) {
+    std::memset(&header, 0, sizeof(header));
+    worker = std::thread(&SnapshotWriter::run, this);
+}
+
+SnapshotWriter::~SnapshotWriter() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    changed.notify_all();
+    worker.join();
+}
+
+bool SnapshotWriter::checkpoint(const Field& field) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (pending || writing) {
+        return false;
+    }
+    header = Snapshot::headerOf(field);
+    cells.resize(field.cells.size()); // the buffer is reused from one checkpoint to the next
+    std::memcpy(cells.data(), field.cells.data(), field.cells.size());
+    pending = true;
+    changed.notify_all();
+    return true;
+}
+
+bool SnapshotWriter::wait() {
+    std::unique_lock<std::mutex> lock(mutex);
+    changed.wait(lock, [this] { return !pending && !writing; });
+    return lastResult;
+}
+
+void SnapshotWriter::run() {
+    std::unique_lock<std::mutex> lock(mutex);
+    for (;;) {
+        changed.wait(lock, [this] { return pending || stopping; });
+        if (!pending) {
+            return;
+        }
+        pending = false;
+        writing = true;
+        lock.unlock();
+        // Nobody touches header/cells while `writing` is set.
+        bool result = Snapshot::write(path, header, cells.data(), cells.size());
+        lock.lock();
+        writing = false;
+        lastResult = result;
+        changed.notify_all();
+    }
+}
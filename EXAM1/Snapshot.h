@@ -0,0 +1,81 @@
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+#include "Field.h"
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// On-disk layout (little-endian), version 1:
+//   bytes 0..4095  SnapshotHeader, zero padded
+//   bytes 4096..   rows * cols packed cells, row-major, one byte each:
+//                  bomb/open/flag bits and the bombs-nearby nibble (see Cell.h)
+// The cells start on a page boundary so the file can be mapped as is.
+struct SnapshotHeader {
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t cellsOffset;
+    std::int32_t rows;
+    std::int32_t cols;
+    std::int32_t totalBombs;
+    std::uint32_t topology; // TopologyKind
+    std::int64_t openedCells;
+    std::uint64_t seed;
+    std::int32_t safeRow;
+    std::int32_t safeCol;
+    std::uint32_t exploded;
+    std::uint32_t placement; // BombPlacement
+};
+
+class Snapshot {
+public:
+    static const std::uint32_t VERSION = 1;
+    static const std::uint32_t CELLS_OFFSET = 4096;
+
+    // Writes header and cells sequentially to path + ".tmp" and renames it
+    // over path, so a crash never leaves a half-written snapshot behind.
+    static bool save(const Field& field, const std::string& path);
+
+    // Maps the snapshot instead of reading it: O(1) whatever the board size,
+    // cells are paged in as they are used and changes stay in memory.
+    // Throws std::runtime_error for a missing, foreign or truncated file.
+    static Field load(const std::string& path);
+
+private:
+    friend class SnapshotWriter;
+
+    static SnapshotHeader headerOf(const Field& field);
+    static bool write(const std::string& path, const SnapshotHeader& header, const void* cells, std::size_t size);
+};
+
+// Periodic checkpoints without stalling play: checkpoint() only copies the
+// cells (a memcpy) and a background thread does the file write.
+class SnapshotWriter {
+private:
+    std::string path;
+    std::thread worker;
+    std::mutex mutex;
+    std::condition_variable changed;
+    SnapshotHeader header;
+    std::vector<Cell> cells;
+    bool pending;
+    bool writing;
+    bool stopping;
+    bool lastResult;
+
+    void run();
+
+public:
+    explicit SnapshotWriter(const std::string& snapshotPath);
+    ~SnapshotWriter();
+
+    // Returns false (and skips this checkpoint) while the previous one is still being written.
+    bool checkpoint(const Field& field);
+    // Blocks until nothing is queued or being written; returns whether the last write succeeded.
+    bool wait();
+};
+
+#endif // SNAPSHOT_H
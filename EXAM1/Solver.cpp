@@ -0,0 +1,382 @@
+#include "Solver.h"
+#include "FieldStats.h"
+#include "FixedField.h"
+
+template <typename Board>
+BasicSolver<Board>::BasicSolver(Board& board) : field(board) {
+    reset();
+}
+
+// assign keeps the capacity, so a reset for a board of the same size or
+// smaller allocates nothing.
+template <typename Board>
+void BasicSolver<Board>::reset() {
+    rows = field.getRows();
+    cols = field.getCols();
+    topology = field.getTopology();
+    knowledge.assign(static_cast<std::size_t>(rows) * cols, UNKNOWN);
+    frontier.clear();
+    frontierPosition.assign(knowledge.size(), -1);
+    queued.assign(knowledge.size(), 0);
+    work.clear();
+    safeCells.clear();
+    knownMines = 0;
+    unknownCells = static_cast<int>(knowledge.size());
+    interiorCursor = 0;
+    for (int cell = 0; cell < static_cast<int>(knowledge.size()); ++cell) {
+        const Cell& state = field.getCell(cell / cols, cell % cols);
+        if (state.getOpen()) {
+            knowledge[cell] = OPENED;
+            --unknownCells;
+        }
+        else if (state.getFlagged()) {
+            knowledge[cell] = MINE;
+            ++knownMines;
+            --unknownCells;
+        }
+    }
+    for (int cell = 0; cell < static_cast<int>(knowledge.size()); ++cell) {
+        if (knowledge[cell] == OPENED && field.getCell(cell / cols, cell % cols).getBombsNearby() > 0) {
+            addToFrontier(cell);
+            enqueue(cell);
+        }
+    }
+
+    // A board generated around a first click: that click is known to be safe.
+    std::pair<int, int> safe = field.getSafeCell();
+    if (unknownCells == static_cast<int>(knowledge.size()) && safe.first >= 0 && safe.first < rows &&
+        safe.second >= 0 && safe.second < cols) {
+        int cell = safe.first * cols + safe.second;
+        withTopology(topology, [this, cell](auto policy) {
+            markSafe<decltype(policy)>(cell);
+        });
+    }
+}
+
+template <typename Board>
+template <typename Topology, typename F>
+void BasicSolver<Board>::forEachNeighbour(int cell, F f) const {
+    static_assert(Topology::MAX_NEIGHBOURS <= MAX_NEIGHBOURS, "Constraint::cells is too small");
+    int width = cols;
+    Topology::forEachNeighbour(cell / cols, cell % cols, rows, cols, [width, &f](int r, int c) {
+        f(r * width + c);
+    });
+}
+
+template <typename Board>
+void BasicSolver<Board>::addToFrontier(int cell) {
+    if (frontierPosition[cell] < 0) {
+        frontierPosition[cell] = static_cast<int>(frontier.size());
+        frontier.push_back(cell);
+    }
+}
+
+template <typename Board>
+void BasicSolver<Board>::removeFromFrontier(int cell) {
+    int position = frontierPosition[cell];
+    if (position < 0) {
+        return;
+    }
+    int last = frontier.back();
+    frontier[position] = last;
+    frontierPosition[last] = position;
+    frontier.pop_back();
+    frontierPosition[cell] = -1;
+}
+
+template <typename Board>
+void BasicSolver<Board>::enqueue(int cell) {
+    if (!queued[cell]) {
+        queued[cell] = 1;
+        work.push_back(cell);
+    }
+}
+
+template <typename Board>
+template <typename Topology>
+void BasicSolver<Board>::enqueueNumbersAround(int cell) {
+    forEachNeighbour<Topology>(cell, [this](int neighbour) {
+        if (frontierPosition[neighbour] >= 0) {
+            enqueue(neighbour);
+        }
+    });
+}
+
+template <typename Board>
+template <typename Topology>
+void BasicSolver<Board>::markSafe(int cell) {
+    if (knowledge[cell] != UNKNOWN) {
+        return;
+    }
+    knowledge[cell] = SAFE;
+    --unknownCells;
+    safeCells.push_back(cell);
+    enqueueNumbersAround<Topology>(cell);
+}
+
+template <typename Board>
+template <typename Topology>
+void BasicSolver<Board>::markMine(int cell) {
+    if (knowledge[cell] != UNKNOWN) {
+        return;
+    }
+    knowledge[cell] = MINE;
+    --unknownCells;
+    ++knownMines;
+    if (!field.getCell(cell / cols, cell % cols).getFlagged()) {
+        field.flagCell(cell / cols, cell % cols);
+    }
+    enqueueNumbersAround<Topology>(cell);
+}
+
+template <typename Board>
+template <typename Topology>
+void BasicSolver<Board>::cellOpened(int cell) {
+    if (knowledge[cell] == OPENED) {
+        return;
+    }
+    if (knowledge[cell] == UNKNOWN) {
+        --unknownCells;
+    }
+    knowledge[cell] = OPENED;
+    enqueueNumbersAround<Topology>(cell);
+    if (field.getCell(cell / cols, cell % cols).getBombsNearby() > 0) {
+        addToFrontier(cell);
+        enqueue(cell);
+    }
+}
+
+template <typename Board>
+void BasicSolver<Board>::onCellsRevealed(const std::vector<RevealedSpan>& spans) {
+    onCellsRevealed(RevealedRange{spans.data(), spans.data() + spans.size()});
+}
+
+template <typename Board>
+void BasicSolver<Board>::onCellsRevealed(RevealedRange spans) {
+    withTopology(topology, [this, &spans](auto policy) {
+        for (const RevealedSpan& span : spans) {
+            for (int col = span.firstCol; col <= span.lastCol; ++col) {
+                cellOpened<decltype(policy)>(span.row * cols + col);
+            }
+        }
+    });
+}
+
+template <typename Board>
+template <typename Topology>
+bool BasicSolver<Board>::touchesOpenCell(int cell) const {
+    bool touches = false;
+    forEachNeighbour<Topology>(cell, [this, &touches](int neighbour) {
+        if (knowledge[neighbour] == OPENED) {
+            touches = true;
+        }
+    });
+    return touches;
+}
+
+// Returns false when the number has no unknown neighbours left.
+template <typename Board>
+template <typename Topology>
+bool BasicSolver<Board>::buildConstraint(int cell, Constraint& constraint) const {
+    constraint.count = 0;
+    constraint.minesLeft = field.getCell(cell / cols, cell % cols).getBombsNearby();
+    forEachNeighbour<Topology>(cell, [this, &constraint](int neighbour) {
+        if (knowledge[neighbour] == UNKNOWN) {
+            constraint.cells[constraint.count++] = neighbour;
+        }
+        else if (knowledge[neighbour] == MINE) {
+            --constraint.minesLeft;
+        }
+    });
+    return constraint.count > 0;
+}
+
+template <typename Board>
+template <typename Topology>
+void BasicSolver<Board>::examine(int cell) {
+    Constraint constraint;
+    if (!buildConstraint<Topology>(cell, constraint)) {
+        removeFromFrontier(cell);
+        return;
+    }
+
+    if (constraint.minesLeft == 0 || constraint.minesLeft == constraint.count) {
+        bool mines = constraint.minesLeft > 0;
+        for (int i = 0; i < constraint.count; ++i) {
+            if (mines) {
+                markMine<Topology>(constraint.cells[i]);
+            }
+            else {
+                markSafe<Topology>(constraint.cells[i]);
+            }
+        }
+        removeFromFrontier(cell);
+        return;
+    }
+
+    // Numbers that are not nearby cannot share an unknown neighbour. Once
+    // a rule fires the rest is skipped and the number is queued again: the
+    // changed cells re-queue the numbers around them, which need not
+    // include this one when it was the smaller side.
+    bool changed = false;
+    Topology::forEachNearby(cell / cols, cell % cols, rows, cols, [this, &constraint, &changed](int r, int c) {
+        int other = r * cols + c;
+        Constraint otherConstraint;
+        if (changed || frontierPosition[other] < 0 || !buildConstraint<Topology>(other, otherConstraint)) {
+            return;
+        }
+        changed = applySubsetRule<Topology>(constraint, otherConstraint) || applySubsetRule<Topology>(otherConstraint, constraint);
+    });
+    if (changed) {
+        enqueue(cell);
+    }
+}
+
+// If every unknown cell of `small` is also around `large`, the cells only
+// around `large` hold exactly large.minesLeft - small.minesLeft mines.
+template <typename Board>
+template <typename Topology>
+bool BasicSolver<Board>::applySubsetRule(const Constraint& small, const Constraint& large) {
+    if (small.count >= large.count) {
+        return false;
+    }
+    int rest[MAX_NEIGHBOURS];
+    int restCount = 0;
+    int shared = 0;
+    for (int i = 0; i < large.count; ++i) {
+        bool inSmall = false;
+        for (int j = 0; j < small.count; ++j) {
+            if (small.cells[j] == large.cells[i]) {
+                inSmall = true;
+                break;
+            }
+        }
+        if (inSmall) {
+            ++shared;
+        }
+        else {
+            rest[restCount++] = large.cells[i];
+        }
+    }
+    if (shared != small.count) {
+        return false;
+    }
+
+    int restMines = large.minesLeft - small.minesLeft;
+    if (restMines != 0 && restMines != restCount) {
+        return false;
+    }
+    for (int i = 0; i < restCount; ++i) {
+        if (restMines == 0) {
+            markSafe<Topology>(rest[i]);
+        }
+        else {
+            markMine<Topology>(rest[i]);
+        }
+    }
+    return true;
+}
+
+template <typename Board>
+Move BasicSolver<Board>::nextMove() {
+    Move move = nextDeducedMove();
+    if (move.row != -1) {
+        return move;
+    }
+    return withTopology(topology, [this](auto policy) {
+        return chooseGuess<decltype(policy)>();
+    });
+}
+
+template <typename Board>
+Move BasicSolver<Board>::nextDeducedMove() {
+    return withTopology(topology, [this](auto policy) {
+        return deduce<decltype(policy)>();
+    });
+}
+
+template <typename Board>
+template <typename Topology>
+Move BasicSolver<Board>::deduce() {
+    for (;;) {
+        while (!safeCells.empty()) {
+            int cell = safeCells.back();
+            safeCells.pop_back();
+            if (knowledge[cell] == SAFE) {
+                return {cell / cols, cell % cols, false};
+            }
+        }
+        if (work.empty()) {
+            break;
+        }
+        int cell = work.back();
+        work.pop_back();
+        queued[cell] = 0;
+        FIELD_STATS_ADD(solverIterations, 1);
+        examine<Topology>(cell);
+    }
+    return {-1, -1, false};
+}
+
+template <typename Board>
+void BasicSolver<Board>::takeSafeCells(std::vector<std::pair<int, int>>& cells) {
+    cells.clear();
+    for (Move move = nextDeducedMove(); move.row != -1; move = nextDeducedMove()) {
+        cells.push_back(std::make_pair(move.row, move.col));
+    }
+}
+
+// Nothing is certain: open the cell least likely to be a mine. A cell away
+// from every number is rated with the interior probability.
+template <typename Board>
+template <typename Topology>
+Move BasicSolver<Board>::chooseGuess() {
+    int size = static_cast<int>(knowledge.size());
+    while (interiorCursor < size && (knowledge[interiorCursor] != UNKNOWN || touchesOpenCell<Topology>(interiorCursor))) {
+        ++interiorCursor;
+    }
+
+    int minesLeft = field.getTotalBombs() - knownMines;
+    probabilities.compute(field, frontier, unknownCells, minesLeft);
+
+    int best = -1;
+    double bestRisk = 2.0;
+    if (interiorCursor < size) {
+        best = interiorCursor;
+        bestRisk = probabilities.getInteriorProbability();
+    }
+    const std::vector<int>& cells = probabilities.getCells();
+    const std::vector<double>& risks = probabilities.getProbabilities();
+    for (std::size_t i = 0; i < cells.size(); ++i) {
+        if (risks[i] < bestRisk) {
+            bestRisk = risks[i];
+            best = cells[i];
+        }
+    }
+
+    if (best < 0) {
+        return {-1, -1, false};
+    }
+    bool certain = probabilities.wasExact() && bestRisk <= 1e-12;
+    return {best / cols, best % cols, !certain};
+}
+
+template <typename Board>
+const std::vector<int>& BasicSolver<Board>::getFrontier() const {
+    return frontier;
+}
+
+template <typename Board>
+int BasicSolver<Board>::getKnownMines() const {
+    return knownMines;
+}
+
+template <typename Board>
+int BasicSolver<Board>::getUnknownCells() const {
+    return unknownCells;
+}
+
+template class BasicSolver<Field>;
+template class BasicSolver<BeginnerField>;
+template class BasicSolver<IntermediateField>;
+template class BasicSolver<ExpertField>;
@@ -0,0 +1,110 @@
+#ifndef SOLVER_H
+#define SOLVER_H
+
+#include "Field.h"
+#include "ProbabilityEngine.h"
+#include <vector>
+
+struct Move {
+    int row;
+    int col;
+    bool guess; // false when the cell is proven safe
+};
+
+// Deterministic minesweeper solver working on top of a board: a Field, or
+// one of the FixedField presets (the instantiations Solver.cpp provides).
+//
+// It keeps the frontier (open numbered cells that still touch unknown
+// cells) up to date as cells are revealed, and a work queue of numbers
+// whose neighbourhood changed since they were last examined. Only those
+// numbers are re-checked with the single-cell rule and the subset rule
+// against the other numbers within two cells, so a move costs time
+// proportional to what the last reveal touched, not to the board size.
+// Cells proven to be mines are flagged on the field. When nothing is
+// certain, the cell with the lowest exact mine probability is opened.
+// Everything that walks neighbourhoods is a template over the field's
+// topology, picked once per public call.
+template <typename Board>
+class BasicSolver {
+private:
+    enum Knowledge : unsigned char { UNKNOWN, SAFE, MINE, OPENED };
+
+    static const int MAX_NEIGHBOURS = 8; // of any topology
+
+    // Closed neighbours of a number whose state is still unknown.
+    struct Constraint {
+        int cells[MAX_NEIGHBOURS];
+        int count;
+        int minesLeft;
+    };
+
+    Board& field;
+    int rows;
+    int cols;
+    TopologyKind topology;
+    std::vector<unsigned char> knowledge;
+    std::vector<int> frontier;         // indices of frontier numbers
+    std::vector<int> frontierPosition; // position in frontier, -1 if absent
+    std::vector<char> queued;
+    std::vector<int> work;
+    std::vector<int> safeCells;        // proven safe, not opened yet
+    int knownMines;
+    int unknownCells;
+    int interiorCursor; // cells before it are decided or touch an open cell
+    ProbabilityEngine probabilities;
+
+    template <typename Topology, typename F>
+    void forEachNeighbour(int cell, F f) const;
+
+    void addToFrontier(int cell);
+    void removeFromFrontier(int cell);
+    void enqueue(int cell);
+    template <typename Topology>
+    void enqueueNumbersAround(int cell);
+    template <typename Topology>
+    void markSafe(int cell);
+    template <typename Topology>
+    void markMine(int cell);
+    template <typename Topology>
+    void cellOpened(int cell);
+
+    template <typename Topology>
+    bool touchesOpenCell(int cell) const;
+    template <typename Topology>
+    bool buildConstraint(int cell, Constraint& constraint) const;
+    template <typename Topology>
+    void examine(int cell);
+    template <typename Topology>
+    bool applySubsetRule(const Constraint& small, const Constraint& large);
+    template <typename Topology>
+    Move deduce();
+    template <typename Topology>
+    Move chooseGuess();
+
+public:
+    explicit BasicSolver(Board& board);
+
+    // Forgets everything and starts again from the board as it is now, for
+    // one solver kept across games on the same board.
+    void reset();
+
+    // Next cell to open, or row == -1 when no closed undecided cell is left.
+    Move nextMove();
+    // Like nextMove, but only cells proven safe by the local rules; row == -1
+    // when the solver would have to fall back to probabilities.
+    Move nextDeducedMove();
+    // Every cell the local rules prove safe from what is open now, for one
+    // Field::openCells call; empty when a guess is needed (or the game is over).
+    void takeSafeCells(std::vector<std::pair<int, int>>& cells);
+    // Must be called after every openCell with field.getLastRevealed().
+    void onCellsRevealed(const std::vector<RevealedSpan>& spans);
+    void onCellsRevealed(RevealedRange spans);
+
+    const std::vector<int>& getFrontier() const;
+    int getKnownMines() const;
+    int getUnknownCells() const; // closed cells not yet proven safe or mined
+};
+
+using Solver = BasicSolver<Field>;
+
+#endif // SOLVER_H
@@ -0,0 +1,167 @@
+#include "TiledField.h"
+#include "Flood.h"
+#include <algorithm>
+
+TiledField::TiledField(const Field& field) : rows(field.getRows()), cols(field.getCols()),
+    totalBombs(field.getTotalBombs()), openedCells(0), exploded(field.isExploded()), table(std::make_shared<TileTable>()) {
+    int tileRows = (rows + TILE_SIZE - 1) >> TILE_SHIFT;
+    int tileCols = (cols + TILE_SIZE - 1) >> TILE_SHIFT;
+    table->rows.reserve(tileRows);
+    for (int tr = 0; tr < tileRows; ++tr) {
+        std::shared_ptr<TileRow> tileRow = std::make_shared<TileRow>();
+        tileRow->tiles.reserve(tileCols);
+        for (int tc = 0; tc < tileCols; ++tc) {
+            std::shared_ptr<Tile> tile = std::make_shared<Tile>();
+            tile->cells.fill(Cell());
+            for (int row = tr * TILE_SIZE; row < std::min(rows, (tr + 1) * TILE_SIZE); ++row) {
+                for (int col = tc * TILE_SIZE; col < std::min(cols, (tc + 1) * TILE_SIZE); ++col) {
+                    const Cell& cell = field.getCell(row, col);
+                    tile->cells[offset(row, col)] = cell;
+                    openedCells += cell.getOpen() && !cell.getBomb() ? 1 : 0;
+                }
+            }
+            tileRow->tiles.push_back(tile);
+        }
+        table->rows.push_back(tileRow);
+    }
+}
+
+// The flood scratch space is not part of the state, so it is not copied.
+TiledField::TiledField(const TiledField& other) : rows(other.rows), cols(other.cols), totalBombs(other.totalBombs),
+    openedCells(other.openedCells), exploded(other.exploded), table(other.table) {}
+
+TiledField& TiledField::operator =(const TiledField& other) {
+    rows = other.rows;
+    cols = other.cols;
+    totalBombs = other.totalBombs;
+    openedCells = other.openedCells;
+    exploded = other.exploded;
+    table = other.table;
+    return *this;
+}
+
+// Clones whatever is shared on the path to the cell: the table, the tile
+// row, the tile. Once this copy owns them, writes go straight through.
+Cell& TiledField::writableCell(int row, int col) {
+    if (table.use_count() > 1) {
+        table = std::make_shared<TileTable>(*table);
+    }
+    std::shared_ptr<TileRow>& tileRow = table->rows[row >> TILE_SHIFT];
+    if (tileRow.use_count() > 1) {
+        tileRow = std::make_shared<TileRow>(*tileRow);
+    }
+    std::shared_ptr<Tile>& tile = tileRow->tiles[col >> TILE_SHIFT];
+    if (tile.use_count() > 1) {
+        tile = std::make_shared<Tile>(*tile);
+    }
+    return tile->cells[offset(row, col)];
+}
+
+// The scanline flood of Field::openCells (see Flood.h); writes go through
+// writableCell, so only the tiles the flood touches are cloned.
+OpenStatus TiledField::openCell(int row, int col) {
+    OpenStatus status = {0, 0, false, -1, -1, false};
+    const Cell& cell = getCell(row, col);
+    if (cell.getFlagged() || cell.getOpen()) {
+        status.skipped = 1;
+        return status;
+    }
+    if (cell.getBomb()) {
+        writableCell(row, col).setOpen();
+        exploded = true;
+        status.exploded = true;
+        status.bombRow = row;
+        status.bombCol = col;
+        return status;
+    }
+
+    long long openedBefore = openedCells;
+    auto open = [this](int r, int c) {
+        const Cell& next = getCell(r, c);
+        if (!next.getOpen() && !next.getFlagged() && !next.getBomb()) {
+            writableCell(r, c).setOpen();
+            ++openedCells;
+        }
+    };
+    if (cell.getBombsNearby() != 0) {
+        open(row, col);
+    }
+    else {
+        floodStack.assign(1, std::make_pair(row, col));
+        scanlineFlood(rows, cols, floodStack, [this](int r, int c) {
+            const Cell& next = getCell(r, c);
+            return !next.getOpen() && !next.getFlagged() && !next.getBomb() && next.getBombsNearby() == 0;
+        }, open);
+    }
+    status.opened = openedCells - openedBefore;
+    return status;
+}
+
+bool TiledField::flagCell(int row, int col) {
+    if (getCell(row, col).getOpen()) {
+        return false;
+    }
+    Cell& cell = writableCell(row, col);
+    cell.setFlagged(!cell.getFlagged());
+    return true;
+}
+
+bool TiledField::checkWin() const {
+    return openedCells == static_cast<long long>(rows) * cols - totalBombs;
+}
+
+bool TiledField::isExploded() const {
+    return exploded;
+}
+
+std::size_t TiledField::getTileCount() const {
+    std::size_t count = 0;
+    for (const std::shared_ptr<TileRow>& tileRow : table->rows) {
+        count += tileRow->tiles.size();
+    }
+    return count;
+}
+
+// A tile is private only if the table, its row and the tile itself are
+// all unshared.
+std::size_t TiledField::getPrivateTileCount() const {
+    if (table.use_count() > 1) {
+        return 0;
+    }
+    std::size_t count = 0;
+    for (const std::shared_ptr<TileRow>& tileRow : table->rows) {
+        if (tileRow.use_count() > 1) {
+            continue;
+        }
+        for (const std::shared_ptr<Tile>& tile : tileRow->tiles) {
+            count += tile.use_count() == 1 ? 1 : 0;
+        }
+    }
+    return count;
+}
+
+UndoHistory::UndoHistory(std::size_t depth) : maxDepth(std::max<std::size_t>(depth, 1)) {}
+
+void UndoHistory::checkpoint(const TiledField& field) {
+    checkpoints.push_back(field);
+    if (checkpoints.size() > maxDepth) {
+        checkpoints.pop_front();
+    }
+}
+
+bool UndoHistory::undo(TiledField& field) {
+    if (checkpoints.empty()) {
+        return false;
+    }
+    field = checkpoints.back();
+    checkpoints.pop_back();
+    return true;
+}
+
+std::size_t UndoHistory::size() const {
+    return checkpoints.size();
+}
+
+void UndoHistory::clear() {
+    checkpoints.clear();
+}
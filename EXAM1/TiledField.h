@@ -0,0 +1,102 @@
+#ifndef TILEDFIELD_H
+#define TILEDFIELD_H
+
+#include "Cell.h"
+#include "Field.h"
+#include <array>
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <utility>
+#include <vector>
+
+// A board made of 64x64 tiles shared between copies until one of them
+// writes (copy-on-write), for undo and what-if search.
+//
+// The tiles hang off a two-level table: the table holds one pointer per
+// row of tiles, each tile row one pointer per tile. Copying a TiledField
+// copies a single pointer. The first write to a shared tile clones the
+// table, that tile row and the tile (a few hundred bytes plus 4 KiB), so
+// a fork that changes k tiles costs O(k) memory whatever the board size,
+// and thousands of forks of a large board fit easily.
+//
+// Sharing is counted with std::shared_ptr, so copies may be read from any
+// thread, but one TiledField (and the copies forked from it) must only be
+// written by one thread at a time.
+class TiledField {
+public:
+    static const int TILE_SHIFT = 6;
+    static const int TILE_SIZE = 1 << TILE_SHIFT;
+
+private:
+    struct Tile {
+        std::array<Cell, TILE_SIZE * TILE_SIZE> cells;
+    };
+
+    struct TileRow {
+        std::vector<std::shared_ptr<Tile>> tiles;
+    };
+
+    struct TileTable {
+        std::vector<std::shared_ptr<TileRow>> rows;
+    };
+
+    int rows;
+    int cols;
+    int totalBombs;
+    long long openedCells;
+    bool exploded;
+    std::shared_ptr<TileTable> table;
+    std::vector<std::pair<int, int>> floodStack; // scratch, not shared
+
+    static int offset(int row, int col) {
+        return ((row & (TILE_SIZE - 1)) << TILE_SHIFT) | (col & (TILE_SIZE - 1));
+    }
+
+    Cell& writableCell(int row, int col);
+
+public:
+    explicit TiledField(const Field& field);
+
+    TiledField(const TiledField& other);
+    TiledField& operator =(const TiledField& other);
+    TiledField(TiledField&& other) = default;
+    TiledField& operator =(TiledField&& other) = default;
+
+    // Same rules as Field::openCell and Field::flagCell, without printing.
+    OpenStatus openCell(int row, int col);
+    bool flagCell(int row, int col); // false for an open cell
+
+    bool checkWin() const;
+    bool isExploded() const;
+
+    int getRows() const { return rows; }
+    int getCols() const { return cols; }
+    int getTotalBombs() const { return totalBombs; }
+    long long getOpenedCells() const { return openedCells; }
+
+    const Cell& getCell(int row, int col) const {
+        return table->rows[row >> TILE_SHIFT]->tiles[col >> TILE_SHIFT]->cells[offset(row, col)];
+    }
+
+    std::size_t getTileCount() const;
+    std::size_t getPrivateTileCount() const; // tiles no other copy shares
+};
+
+// Undo for a TiledField: every checkpoint is a fork, so it costs O(1) when
+// taken and afterwards only the tiles changed since then.
+class UndoHistory {
+private:
+    std::deque<TiledField> checkpoints;
+    std::size_t maxDepth;
+
+public:
+    explicit UndoHistory(std::size_t depth = 1000);
+
+    void checkpoint(const TiledField& field); // drops the oldest beyond maxDepth
+    bool undo(TiledField& field);             // false if there is nothing to undo
+    std::size_t size() const;
+    void clear();
+};
+
+#endif // TILEDFIELD_H
@@ -0,0 +1,137 @@
+#ifndef TOPOLOGY_H
+#define TOPOLOGY_H
+
+// Which cells are neighbours, as compile-time policies.
+//
+// Counting, flooding and the solver are templates over one of these, so
+// every topology gets its own loops with no per-cell test of which board
+// it is; a Field stores its TopologyKind and picks the instantiation once
+// per call through withTopology. Each policy provides:
+//   forEachNeighbour(row, col, rows, cols, f)  f(r, c) for every distinct
+//                                              neighbour, not the cell itself
+//   forEachNearby(row, col, rows, cols, f)     f(r, c) for cells that can share
+//                                              a neighbour with it (a superset)
+//   MAX_NEIGHBOURS
+//
+// Only Field, Solver, ProbabilityEngine, BoardAnalyzer and the no-guess
+// generator know about topologies; the fixed-size, tiled and chunked
+// boards are square only.
+enum TopologyKind : unsigned char { TOPOLOGY_SQUARE, TOPOLOGY_TORUS, TOPOLOGY_HEX };
+
+// The classic 8-neighbour board.
+struct SquareTopology {
+    static const TopologyKind KIND = TOPOLOGY_SQUARE;
+    static const int MAX_NEIGHBOURS = 8;
+
+    template <typename F>
+    static void forEachNeighbour(int row, int col, int rows, int cols, F f) {
+        for (int r = row - 1; r <= row + 1; ++r) {
+            if (r < 0 || r >= rows) {
+                continue;
+            }
+            for (int c = col - 1; c <= col + 1; ++c) {
+                if (c >= 0 && c < cols && (r != row || c != col)) {
+                    f(r, c);
+                }
+            }
+        }
+    }
+
+    template <typename F>
+    static void forEachNearby(int row, int col, int rows, int cols, F f) {
+        for (int r = row - 2; r <= row + 2; ++r) {
+            if (r < 0 || r >= rows) {
+                continue;
+            }
+            for (int c = col - 2; c <= col + 2; ++c) {
+                if (c >= 0 && c < cols && (r != row || c != col)) {
+                    f(r, c);
+                }
+            }
+        }
+    }
+};
+
+// 8 neighbours, with the edges wrapped around. On a board narrower than
+// three cells the wrapped neighbours coincide; each is reported once.
+struct TorusTopology {
+    static const TopologyKind KIND = TOPOLOGY_TORUS;
+    static const int MAX_NEIGHBOURS = 8;
+
+    template <typename F>
+    static void forEachNeighbour(int row, int col, int rows, int cols, F f) {
+        int rowsAround[3] = {row, row == 0 ? rows - 1 : row - 1, row == rows - 1 ? 0 : row + 1};
+        int colsAround[3] = {col, col == 0 ? cols - 1 : col - 1, col == cols - 1 ? 0 : col + 1};
+        int rowCount = rows >= 3 ? 3 : rows;
+        int colCount = cols >= 3 ? 3 : cols;
+        for (int i = 0; i < rowCount; ++i) {
+            for (int j = (i == 0 ? 1 : 0); j < colCount; ++j) {
+                f(rowsAround[i], colsAround[j]);
+            }
+        }
+    }
+
+    // May report a cell more than once on boards smaller than 5x5.
+    template <typename F>
+    static void forEachNearby(int row, int col, int rows, int cols, F f) {
+        for (int dr = -2; dr <= 2; ++dr) {
+            int r = ((row + dr) % rows + rows) % rows;
+            for (int dc = -2; dc <= 2; ++dc) {
+                int c = ((col + dc) % cols + cols) % cols;
+                if (r != row || c != col) {
+                    f(r, c);
+                }
+            }
+        }
+    }
+};
+
+// Hexagons in "odd-r" offset layout: odd rows are drawn half a cell to
+// the right, so a cell touches two cells above and two below, at columns
+// (col - 1, col) on an even row and (col, col + 1) on an odd one.
+struct HexTopology {
+    static const TopologyKind KIND = TOPOLOGY_HEX;
+    static const int MAX_NEIGHBOURS = 6;
+
+    template <typename F>
+    static void forEachNeighbour(int row, int col, int rows, int cols, F f) {
+        int shift = row & 1;
+        for (int r = row - 1; r <= row + 1; r += 2) {
+            if (r < 0 || r >= rows) {
+                continue;
+            }
+            for (int c = col - 1 + shift; c <= col + shift; ++c) {
+                if (c >= 0 && c < cols) {
+                    f(r, c);
+                }
+            }
+        }
+        if (col > 0) {
+            f(row, col - 1);
+        }
+        if (col < cols - 1) {
+            f(row, col + 1);
+        }
+    }
+
+    template <typename F>
+    static void forEachNearby(int row, int col, int rows, int cols, F f) {
+        SquareTopology::forEachNearby(row, col, rows, cols, f);
+    }
+};
+
+// Calls visit with a value of the policy type for kind, so the caller's
+// generic lambda is instantiated once per topology:
+//   withTopology(kind, [&](auto topology) { run<decltype(topology)>(); });
+template <typename Visitor>
+auto withTopology(TopologyKind kind, Visitor visit) -> decltype(visit(SquareTopology())) {
+    if (kind == TOPOLOGY_TORUS) {
+        return visit(TorusTopology());
+    }
+    if (kind == TOPOLOGY_HEX) {
+        return visit(HexTopology());
+    }
+    return visit(SquareTopology());
+}
+
+#endif // TOPOLOGY_H
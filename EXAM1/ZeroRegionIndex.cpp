@@ -0,0 +1,146 @@
+#include "ZeroRegionIndex.h"
+#include <algorithm>
+#include <limits>
+#include <utility>
+
+ZeroRegionIndex::ZeroRegionIndex() : isolatedNumbers(0), built(false), topology(TOPOLOGY_SQUARE) {}
+
+// Calls f once for every distinct region touching the cell (the cell's
+// own region included).
+template <typename Topology, typename F>
+void ZeroRegionIndex::forEachNeighbourRegion(int rows, int cols, int row, int col, F f) const {
+    int found[Topology::MAX_NEIGHBOURS + 1];
+    int count = 0;
+    auto visit = [this, cols, &found, &count, &f](int r, int c) {
+        int region = regionOf[static_cast<std::size_t>(r) * cols + c];
+        if (region < 0) {
+            return;
+        }
+        bool seen = false;
+        for (int i = 0; i < count && !seen; ++i) {
+            seen = found[i] == region;
+        }
+        if (!seen) {
+            found[count++] = region;
+            f(region);
+        }
+    };
+    visit(row, col);
+    Topology::forEachNeighbour(row, col, rows, cols, visit);
+}
+
+bool ZeroRegionIndex::build(const Cell* cells, int rows, int cols, TopologyKind kind) {
+    clear();
+    if (static_cast<unsigned long long>(rows) * cols > std::numeric_limits<std::uint32_t>::max()) {
+        return false;
+    }
+    topology = kind;
+    withTopology(kind, [this, cells, rows, cols](auto policy) {
+        buildWith<decltype(policy)>(cells, rows, cols);
+    });
+    return true;
+}
+
+template <typename Topology>
+void ZeroRegionIndex::buildWith(const Cell* cells, int rows, int cols) {
+    std::size_t size = static_cast<std::size_t>(rows) * cols;
+    regionOf.assign(size, -1);
+    int regions = 0;
+
+    // Label: breadth-first over connected zero cells.
+    for (std::size_t start = 0; start < size; ++start) {
+        if (regionOf[start] >= 0 || cells[start].getBomb() || cells[start].getBombsNearby() != 0) {
+            continue;
+        }
+        regionOf[start] = regions;
+        queue.assign(1, std::make_pair(static_cast<int>(start / cols), static_cast<int>(start % cols)));
+        for (std::size_t head = 0; head < queue.size(); ++head) {
+            int row = queue[head].first;
+            int col = queue[head].second;
+            Topology::forEachNeighbour(row, col, rows, cols, [this, cells, cols, regions](int r, int c) {
+                std::size_t next = static_cast<std::size_t>(r) * cols + c;
+                if (regionOf[next] < 0 && !cells[next].getBomb() && cells[next].getBombsNearby() == 0) {
+                    regionOf[next] = regions;
+                    queue.push_back(std::make_pair(r, c));
+                }
+            });
+        }
+        ++regions;
+    }
+
+    // Two row-major passes (count, then fill) keep every member list sorted.
+    regionStart.assign(regions + 1, 0);
+    regionFlags.assign(regions, 0);
+    isolatedNumbers = 0;
+    for (int row = 0; row < rows; ++row) {
+        for (int col = 0; col < cols; ++col) {
+            const Cell& cell = cells[static_cast<std::size_t>(row) * cols + col];
+            if (cell.getBomb()) {
+                continue;
+            }
+            bool touches = false;
+            bool flagged = cell.getFlagged();
+            forEachNeighbourRegion<Topology>(rows, cols, row, col, [this, &touches, flagged](int region) {
+                ++regionStart[region + 1];
+                regionFlags[region] += flagged ? 1 : 0;
+                touches = true;
+            });
+            if (!touches) {
+                ++isolatedNumbers;
+            }
+        }
+    }
+    for (int region = 0; region < regions; ++region) {
+        regionStart[region + 1] += regionStart[region];
+    }
+    members.resize(regionStart[regions]);
+    nextMember.assign(regionStart.begin(), regionStart.end() - 1);
+    for (int row = 0; row < rows; ++row) {
+        for (int col = 0; col < cols; ++col) {
+            std::size_t cell = static_cast<std::size_t>(row) * cols + col;
+            if (!cells[cell].getBomb()) {
+                forEachNeighbourRegion<Topology>(rows, cols, row, col, [this, cell](int region) {
+                    members[nextMember[region]++] = static_cast<std::uint32_t>(cell);
+                });
+            }
+        }
+    }
+    queue.clear();
+    nextMember.clear();
+    built = true;
+}
+
+void ZeroRegionIndex::clear() {
+    regionOf.clear();
+    regionStart.clear();
+    members.clear();
+    regionFlags.clear();
+    isolatedNumbers = 0;
+    built = false;
+}
+
+bool ZeroRegionIndex::isBuilt() const {
+    return built;
+}
+
+void ZeroRegionIndex::flagChanged(int rows, int cols, std::size_t cell, bool flagged) {
+    int row = static_cast<int>(cell / cols);
+    int col = static_cast<int>(cell % cols);
+    withTopology(topology, [this, rows, cols, row, col, flagged](auto policy) {
+        forEachNeighbourRegion<decltype(policy)>(rows, cols, row, col, [this, flagged](int region) {
+            regionFlags[region] += flagged ? 1 : -1;
+        });
+    });
+}
+
+int ZeroRegionIndex::getOpenings() const {
+    return static_cast<int>(regionFlags.size());
+}
+
+int ZeroRegionIndex::getIsolatedNumbers() const {
+    return isolatedNumbers;
+}
+
+int ZeroRegionIndex::get3BV() const {
+    return getOpenings() + isolatedNumbers;
+}
@@ -0,0 +1,1531 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <new>
+#include <set>
+#include <streambuf>
+#include <string>
+#include <thread>
+#include <vector>
+#include "BoardAnalyzer.h"
+#include "ChunkedField.h"
+#include "Field.h"
+#include "FieldStats.h"
+#include "FixedField.h"
+#include "GameFarm.h"
+#include "Journal.h"
+#include "NoGuessGenerator.h"
+#include "ProbabilityEngine.h"
+#include "Random.h"
+#include "Renderer.h"
+#include "SessionManager.h"
+#include "Simulation.h"
+#include "Snapshot.h"
+#include "Solver.h"
+#include "TiledField.h"
+#include <sys/resource.h>
+#include <unistd.h>
+
+// Benchmarks for the Minesweeper engine.
+//   g++ -O2 -std=c++17 benchmark.cpp Field.cpp BombCounter.cpp Solver.cpp ProbabilityEngine.cpp Simulation.cpp
+//       GameFarm.cpp Renderer.cpp CellStorage.cpp ZeroRegionIndex.cpp BoardAnalyzer.cpp
+//       NoGuessGenerator.cpp Journal.cpp FieldStats.cpp SessionManager.cpp TiledField.cpp
+//       ChunkedField.cpp Snapshot.cpp -pthread -o benchmark
+//   (add -DFIELD_STATS to print the hot-path counters after the run)
+//   ./benchmark probability [positions]
+//   ./benchmark simulate [games]
+//   ./benchmark farm [games]
+//   ./benchmark render [frames]
+//   ./benchmark analyze [boards]
+//   ./benchmark noguess [boards]
+//   ./benchmark replay [games]
+//   ./benchmark hotpaths [json file] [largest autoplay side]
+//   ./benchmark fixed [games]
+//   ./benchmark batch [games]
+//   ./benchmark sessions [seconds per step]
+//   ./benchmark forks [forks]
+//   ./benchmark topology [games]
+//   ./benchmark parallel [side] [threads]
+//   ./benchmark chunked [clicks]
+//   ./benchmark checkpoint [side] [checkpoints]
+//   ./benchmark boards                     (exits with 1 if a check fails)
+
+// Every allocation in the process goes through here, so the hot-path
+// benchmark can report how many a call makes.
+std::atomic<long long> allocationCount(0);
+
+void* operator new(std::size_t size) {
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    if (void* memory = std::malloc(size ? size : 1)) {
+        return memory;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* memory) noexcept {
+    std::free(memory);
+}
+
+void operator delete(void* memory, std::size_t) noexcept {
+    std::free(memory);
+}
+
+namespace {
+
+double secondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+struct Position {
+    Field field;
+    std::vector<int> frontier;
+    int unknownCells;
+    int minesLeft;
+};
+
+// Expert boards (16x30, 99 mines, safe first click in the middle) played
+// by the solver up to the first move where it has to guess.
+std::vector<Position> expertPositions(int count) {
+    std::vector<Position> positions;
+    for (std::uint64_t seed = 1; static_cast<int>(positions.size()) < count; ++seed) {
+        Field field(16, 30, 99);
+        field.placeBombs(seed, 8, 15);
+        field.calculateBombsNearby();
+        field.openCell(8, 15);
+        Solver solver(field);
+        solver.onCellsRevealed(field.getLastRevealed());
+
+        Move move = solver.nextMove();
+        while (move.row != -1 && !move.guess) {
+            field.openCell(move.row, move.col);
+            solver.onCellsRevealed(field.getLastRevealed());
+            move = solver.nextMove();
+        }
+        if (move.row != -1 && !field.checkWin()) {
+            positions.push_back({field, solver.getFrontier(), solver.getUnknownCells(),
+                                 field.getTotalBombs() - solver.getKnownMines()});
+        }
+    }
+    return positions;
+}
+
+void benchmarkProbability(int count) {
+    std::vector<Position> positions = expertPositions(count);
+
+    int exact = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (const Position& position : positions) {
+        ProbabilityEngine engine;
+        engine.compute(position.field, position.frontier, position.unknownCells, position.minesLeft);
+        exact += engine.wasExact() ? 1 : 0;
+    }
+    double cold = secondsSince(start);
+
+    ProbabilityEngine engine;
+    for (const Position& position : positions) {
+        engine.compute(position.field, position.frontier, position.unknownCells, position.minesLeft);
+    }
+    start = std::chrono::steady_clock::now();
+    for (const Position& position : positions) {
+        engine.compute(position.field, position.frontier, position.unknownCells, position.minesLeft);
+    }
+    double warm = secondsSince(start);
+
+    std::cout << "probability: " << positions.size() << " expert positions, " << exact << " exact" << std::endl;
+    std::cout << "  cold: " << positions.size() / cold << " positions/s" << std::endl;
+    std::cout << "  memoized: " << positions.size() / warm << " positions/s" << std::endl;
+}
+
+void benchmarkSimulation(int games) {
+    struct Preset {
+        const char* name;
+        int rows;
+        int cols;
+        int bombs;
+    };
+    const Preset presets[] = {{"beginner", 9, 9, 10}, {"intermediate", 16, 16, 40}, {"expert", 16, 30, 99}};
+
+    for (const Preset& preset : presets) {
+        auto start = std::chrono::steady_clock::now();
+        SimulationStats stats = simulateGames(preset.rows, preset.cols, preset.bombs, 1, games);
+        double elapsed = secondsSince(start);
+        std::cout << preset.name << ": " << stats.games << " games, win rate " << stats.winRate() * 100 << "%, "
+                  << stats.movesPerGame() << " moves/game, " << stats.guessesPerGame() << " guesses/game, "
+                  << stats.secondsPerGame() * 1e6 << " us/game, " << stats.games / elapsed << " games/s" << std::endl;
+    }
+}
+
+// Expert games on 1, 2, 4, ... threads; the counters must match across runs.
+void benchmarkFarm(long long games) {
+    int cores = std::max(1u, std::thread::hardware_concurrency());
+    for (int threads = 1; threads <= cores; threads *= 2) {
+        FarmConfig config = {16, 30, 99, 12345, games, threads, 64};
+        auto start = std::chrono::steady_clock::now();
+        SimulationStats stats = runGameFarm(config);
+        double elapsed = secondsSince(start);
+        std::cout << "farm: " << threads << " threads, " << stats.games << " games, " << stats.wins << " wins, "
+                  << stats.moves << " moves, " << stats.guesses << " guesses, " << stats.games / elapsed << " games/s" << std::endl;
+    }
+}
+
+// Frames per second on a 200x200 board, written to /dev/null.
+void benchmarkRender(int frames) {
+    Field field(200, 200, 6000);
+    field.placeBombs(7, 100, 100);
+    field.calculateBombsNearby();
+    field.openCell(100, 100);
+
+    // The per-cell stream insertions displayField used to do, for reference.
+    std::ofstream nullStream("/dev/null");
+    auto start = std::chrono::steady_clock::now();
+    for (int frame = 0; frame < frames; ++frame) {
+        for (int i = 0; i < field.getRows(); ++i) {
+            for (int j = 0; j < field.getCols(); ++j) {
+                const Cell& cell = field.getCell(i, j);
+                if (cell.getOpen()) {
+                    nullStream << cell.getBombsNearby() << " ";
+                }
+                else {
+                    nullStream << ". ";
+                }
+            }
+            nullStream << std::endl;
+        }
+    }
+    std::cout << "render: per-cell stream " << frames / secondsSince(start) << " frames/s" << std::endl;
+
+    std::FILE* sink = std::fopen("/dev/null", "w");
+    FieldRenderer renderer(sink);
+    start = std::chrono::steady_clock::now();
+    for (int frame = 0; frame < frames; ++frame) {
+        renderer.drawFull(field, false);
+    }
+    std::cout << "render: full frame " << frames / secondsSince(start) << " frames/s" << std::endl;
+
+    // Replay a solver game, repainting only what each move revealed.
+    field.placeBombs(7, 100, 100);
+    field.calculateBombsNearby();
+    Solver solver(field);
+    std::vector<std::vector<RevealedSpan>> reveals;
+    for (Move move = solver.nextMove(); move.row != -1 && !field.isExploded() && !field.checkWin(); move = solver.nextMove()) {
+        field.openCell(move.row, move.col);
+        solver.onCellsRevealed(field.getLastRevealed());
+        reveals.push_back(field.getLastRevealed());
+    }
+    start = std::chrono::steady_clock::now();
+    int drawn = 0;
+    while (drawn < frames) {
+        for (std::size_t i = 0; i < reveals.size() && drawn < frames; ++i, ++drawn) {
+            renderer.drawChanges(field, reveals[i], false);
+        }
+    }
+    std::cout << "render: changed cells only " << frames / secondsSince(start) << " frames/s" << std::endl;
+
+    // Nothing changed since the last frame: the cost of finding that out.
+    renderer.drawFull(field, false);
+    start = std::chrono::steady_clock::now();
+    for (int frame = 0; frame < frames; ++frame) {
+        renderer.drawUpdate(field, false);
+    }
+    std::cout << "render: diff against the screen " << frames / secondsSince(start) << " frames/s" << std::endl;
+    std::fclose(sink);
+}
+
+// Boards per second through the difficulty analyzer, per preset, on the
+// boards analyzeGeneratedBoards would make (generated beforehand).
+void benchmarkAnalyzer(int boards) {
+    struct Preset {
+        const char* name;
+        int rows;
+        int cols;
+        int bombs;
+    };
+    const Preset presets[] = {{"beginner", 9, 9, 10}, {"intermediate", 16, 16, 40}, {"expert", 16, 30, 99}};
+
+    for (const Preset& preset : presets) {
+        std::vector<Field> generated(boards, Field(preset.rows, preset.cols, preset.bombs));
+        for (int board = 0; board < boards; ++board) {
+            generated[board].placeBombs(1 + board, preset.rows / 2, preset.cols / 2);
+            generated[board].calculateBombsNearby();
+        }
+        BoardAnalyzer analyzer;
+        std::vector<BoardDifficulty> results;
+        results.reserve(boards);
+        long long allocations = allocationCount.load();
+        auto start = std::chrono::steady_clock::now();
+        analyzer.analyze(generated, results);
+        double elapsed = secondsSince(start);
+        allocations = allocationCount.load() - allocations;
+        long long bbbv = 0;
+        int noGuess = 0;
+        for (const BoardDifficulty& result : results) {
+            bbbv += result.bbbv;
+            noGuess += result.requiresGuessing ? 0 : 1;
+        }
+        std::cout << preset.name << ": " << boards << " boards, " << static_cast<double>(bbbv) / boards << " 3BV/board, "
+                  << noGuess << " without guessing, " << boards / elapsed << " boards/s, "
+                  << static_cast<double>(allocations) / boards << " allocations/board" << std::endl;
+    }
+}
+
+// Expert no-guess boards per second, on one thread and through the pool.
+void benchmarkNoGuess(int boards) {
+    NoGuessGenerator generator;
+    Field field(16, 30, 99);
+    int generated = 0;
+    std::uint64_t seed = 1;
+    auto start = std::chrono::steady_clock::now();
+    for (; generated < boards; ++seed) {
+        generated += generator.generate(seed, 8, 15, field) ? 1 : 0;
+    }
+    double elapsed = secondsSince(start);
+    std::cout << "noguess: " << generated << " boards from " << seed - 1 << " seeds, "
+              << static_cast<double>(generator.getRepairs()) / (seed - 1) << " repairs/seed, "
+              << generated / elapsed << " boards/s" << std::endl;
+
+    NoGuessPool pool(16, 30, 99, 1, 256);
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < boards && pool.take(field); ++i) {
+    }
+    std::cout << "noguess pool: " << std::max(1u, std::thread::hardware_concurrency()) << " threads, "
+              << boards / secondsSince(start) << " boards/s" << std::endl;
+}
+
+// Records expert solver games, then replays them in full and seeks into them.
+void benchmarkReplay(int games) {
+    std::vector<MoveJournal> journals(games);
+    long long moves = 0;
+    std::size_t bytes = 0;
+    for (int game = 0; game < games; ++game) {
+        Field field(16, 30, 99);
+        field.placeBombs(game + 1, 8, 15);
+        field.calculateBombsNearby();
+        field.setJournal(&journals[game]);
+        playGame(field);
+        moves += journals[game].getMoveCount();
+        bytes += journals[game].getByteSize();
+    }
+    std::cout << "replay: " << games << " games, " << moves << " actions, "
+              << static_cast<double>(bytes) / moves << " bytes/action" << std::endl;
+
+    auto start = std::chrono::steady_clock::now();
+    for (const MoveJournal& journal : journals) {
+        Replay replay(journal);
+        replay.seek(journal.getMoveCount());
+    }
+    std::cout << "  full replay: " << moves / secondsSince(start) << " actions/s" << std::endl;
+
+    std::vector<Replay> replays;
+    for (const MoveJournal& journal : journals) {
+        replays.emplace_back(journal, 16);
+        replays.back().seek(journal.getMoveCount()); // lays down the keyframes
+    }
+    SplitMix64 random(1);
+    const int seeks = 100000;
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < seeks; ++i) {
+        Replay& replay = replays[random.nextBelow(replays.size())];
+        replay.seek(random.nextBelow(replay.getMoveCount() + 1));
+    }
+    std::cout << "  random seek (keyframe every 16 actions): " << seeks / secondsSince(start) << " seeks/s" << std::endl;
+}
+
+// Swallows whatever displayField writes while std::cout points at it.
+class NullBuffer : public std::streambuf {
+protected:
+    int overflow(int c) override {
+        return c;
+    }
+    std::streamsize xsputn(const char*, std::streamsize count) override {
+        return count;
+    }
+};
+
+// Peak resident set size in KiB. On Linux the peak is reset before every
+// measurement (clear_refs), so it belongs to that measurement alone;
+// elsewhere it is the process-wide maximum so far.
+void resetPeakRss() {
+#ifdef __linux__
+    if (std::FILE* refs = std::fopen("/proc/self/clear_refs", "w")) {
+        std::fputs("5", refs);
+        std::fclose(refs);
+    }
+#endif
+}
+
+long peakRssKiB() {
+#ifdef __linux__
+    if (std::FILE* status = std::fopen("/proc/self/status", "r")) {
+        char line[256];
+        long peak = -1;
+        while (std::fgets(line, sizeof(line), status)) {
+            if (std::strncmp(line, "VmHWM:", 6) == 0) {
+                peak = std::atol(line + 6);
+            }
+        }
+        std::fclose(status);
+        if (peak >= 0) {
+            return peak;
+        }
+    }
+#endif
+    rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss;
+}
+
+struct HotPathResult {
+    const char* operation;
+    int side;
+    int density; // percent
+    int runs;
+    double nsPerCell;
+    double allocationsPerRun;
+    long peakRss;
+};
+
+// Runs `body` until about 0.2 s have been spent in it (at least once);
+// `setup` runs before every call and is not timed.
+template <typename Setup, typename Body>
+HotPathResult measure(const char* operation, int side, int density, Setup setup, Body body) {
+    double cells = static_cast<double>(side) * side;
+    double elapsed = 0.0;
+    long long allocations = 0;
+    int runs = 0;
+    resetPeakRss();
+    do {
+        setup();
+        long long allocationsBefore = allocationCount.load(std::memory_order_relaxed);
+        auto start = std::chrono::steady_clock::now();
+        body();
+        elapsed += secondsSince(start);
+        allocations += allocationCount.load(std::memory_order_relaxed) - allocationsBefore;
+        ++runs;
+    } while (elapsed < 0.2);
+    return {operation, side, density, runs, elapsed * 1e9 / (cells * runs), static_cast<double>(allocations) / runs, peakRssKiB()};
+}
+
+// ns/cell, allocations per call and peak RSS of the Field hot paths over
+// square boards from 9x9 to 8192x8192 and densities from 1% to 40%.
+// "autoplay" is the headless playGame loop behind Field::autoplay (which
+// sleeps between moves); it is skipped above maxAutoplaySide.
+void benchmarkHotPaths(const char* jsonPath, int maxAutoplaySide) {
+    const int sides[] = {9, 16, 64, 256, 1024, 4096, 8192};
+    const int densities[] = {1, 5, 10, 20, 40};
+    std::vector<HotPathResult> results;
+    NullBuffer nullBuffer;
+
+    for (int side : sides) {
+        for (int density : densities) {
+            int bombs = static_cast<int>(static_cast<long long>(side) * side * density / 100);
+            Field field(side, side, bombs);
+            std::uint64_t seed = 1;
+            auto place = [&field, &seed, side] {
+                field.placeBombs(seed++, side / 2, side / 2);
+            };
+            auto placeAndCount = [&field, &seed, side] {
+                field.placeBombs(seed++, side / 2, side / 2);
+                field.calculateBombsNearby();
+            };
+            auto nothing = [] {};
+            std::size_t first = results.size();
+
+            results.push_back(measure("placeBombs", side, density, nothing, place));
+            results.push_back(measure("calculateBombsNearby", side, density, place, [&field] {
+                field.calculateBombsNearby();
+            }));
+            // Opens every opening of the board, one openCell per zero region.
+            results.push_back(measure("openCell", side, density, placeAndCount, [&field, side] {
+                for (int row = 0; row < side; ++row) {
+                    for (int col = 0; col < side; ++col) {
+                        const Cell& cell = field.getCell(row, col);
+                        if (!cell.getOpen() && !cell.getBomb() && cell.getBombsNearby() == 0) {
+                            field.openCell(row, col);
+                        }
+                    }
+                }
+            }));
+            std::streambuf* console = std::cout.rdbuf(&nullBuffer);
+            results.push_back(measure("displayField", side, density, nothing, [&field] {
+                field.displayField(false);
+            }));
+            std::cout.rdbuf(console);
+            if (side <= maxAutoplaySide) {
+                results.push_back(measure("autoplay", side, density, placeAndCount, [&field] {
+                    playGame(field);
+                }));
+            }
+
+            std::cout << side << "x" << side << " " << density << "%:";
+            for (std::size_t i = first; i < results.size(); ++i) {
+                std::cout << " " << results[i].operation << " " << results[i].nsPerCell << " ns/cell";
+            }
+            std::cout << std::endl;
+        }
+    }
+
+    std::ofstream json(jsonPath);
+    json << "{\n  \"benchmark\": \"hotpaths\",\n  \"results\": [\n";
+    for (std::size_t i = 0; i < results.size(); ++i) {
+        const HotPathResult& result = results[i];
+        json << "    {\"operation\": \"" << result.operation << "\", \"rows\": " << result.side
+             << ", \"cols\": " << result.side << ", \"density\": " << result.density / 100.0
+             << ", \"runs\": " << result.runs << ", \"ns_per_cell\": " << result.nsPerCell
+             << ", \"allocations_per_run\": " << result.allocationsPerRun
+             << ", \"peak_rss_kib\": " << result.peakRss << "}" << (i + 1 < results.size() ? "," : "") << "\n";
+    }
+    json << "  ]\n}\n";
+    std::cout << "hotpaths: " << results.size() << " measurements written to " << jsonPath << std::endl;
+}
+
+// The board side of a won game: place, count, open the safe click, then
+// open every other safe cell. Works on Field and FixedField alike.
+template <typename Board>
+long long playBoard(Board& board, std::uint64_t seed) {
+    int rows = board.getRows();
+    int cols = board.getCols();
+    board.placeBombs(seed, rows / 2, cols / 2);
+    board.calculateBombsNearby();
+    long long spans = 0;
+    for (int row = 0; row < rows; ++row) {
+        for (int col = 0; col < cols; ++col) {
+            const Cell& cell = board.getCell((row + rows / 2) % rows, (col + cols / 2) % cols);
+            if (!cell.getOpen() && !cell.getBomb()) {
+                board.openCell((row + rows / 2) % rows, (col + cols / 2) % cols);
+                spans += static_cast<long long>(board.getLastRevealed().size());
+            }
+        }
+    }
+    return spans;
+}
+
+// The simulation loop: the solver plays the board from the safe click.
+template <typename Board>
+long long solveBoard(Board& board, std::uint64_t seed) {
+    board.placeBombs(seed, board.getRows() / 2, board.getCols() / 2);
+    board.calculateBombsNearby();
+    GameResult result = playGame(board);
+    return result.moves * 2 + (result.won ? 1 : 0);
+}
+
+// Games per second of Field and FixedField<R, C> with play(board, seed),
+// on the same seeds.
+template <int R, int C, typename Play>
+void compareFixedWith(const char* name, int bombs, int games, Play play) {
+    Field dynamicBoard(R, C, bombs);
+    long long dynamicResults = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int game = 0; game < games; ++game) {
+        dynamicResults += play(dynamicBoard, game + 1);
+    }
+    double dynamicSeconds = secondsSince(start);
+
+    FixedField<R, C> fixedBoard(bombs);
+    long long fixedResults = 0;
+    start = std::chrono::steady_clock::now();
+    for (int game = 0; game < games; ++game) {
+        fixedResults += play(fixedBoard, game + 1);
+    }
+    double fixedSeconds = secondsSince(start);
+
+    std::cout << name << ": Field " << games / dynamicSeconds << " games/s, FixedField<" << R << ", " << C << "> "
+              << games / fixedSeconds << " games/s (x" << dynamicSeconds / fixedSeconds << ")"
+              << (dynamicResults == fixedResults ? "" : ", RESULTS DIFFER") << std::endl;
+}
+
+template <int R, int C>
+void compareFixed(const char* name, int bombs, int games) {
+    compareFixedWith<R, C>(name, bombs, games, [](auto& board, std::uint64_t seed) {
+        return playBoard(board, seed);
+    });
+    std::string solved = std::string(name) + " with the solver";
+    compareFixedWith<R, C>(solved.c_str(), bombs, games / 10, [](auto& board, std::uint64_t seed) {
+        return solveBoard(board, seed);
+    });
+}
+
+void benchmarkFixed(int games) {
+    compareFixed<9, 9>("beginner", 10, games);
+    compareFixed<16, 16>("intermediate", 40, games);
+    compareFixed<16, 30>("expert", 99, games);
+}
+
+// Expert games where the solver's safe cells are opened one openCell at a
+// time, then as one openCells batch per solver step.
+void benchmarkBatchOpen(int games) {
+    Field field(16, 30, 99);
+    long long wins = 0;
+    long long calls = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int game = 0; game < games; ++game) {
+        field.placeBombs(game + 1, 8, 15);
+        field.calculateBombsNearby();
+        GameResult result = playGame(field);
+        wins += result.won ? 1 : 0;
+        calls += result.moves;
+    }
+    std::cout << "openCell per move: " << games / secondsSince(start) << " games/s, " << wins << " wins, "
+              << static_cast<double>(calls) / games << " open calls/game" << std::endl;
+
+    std::vector<std::pair<int, int>> safe;
+    wins = 0;
+    calls = 0;
+    start = std::chrono::steady_clock::now();
+    for (int game = 0; game < games; ++game) {
+        field.placeBombs(game + 1, 8, 15);
+        field.calculateBombsNearby();
+        Solver solver(field);
+        while (!field.isExploded() && !field.checkWin()) {
+            solver.takeSafeCells(safe);
+            if (safe.empty()) {
+                Move move = solver.nextMove();
+                if (move.row == -1) {
+                    break;
+                }
+                safe.push_back(std::make_pair(move.row, move.col));
+            }
+            field.openCells(safe);
+            solver.onCellsRevealed(field.getLastRevealed());
+            ++calls;
+        }
+        wins += field.checkWin() ? 1 : 0;
+    }
+    std::cout << "openCells per step: " << games / secondsSince(start) << " games/s, " << wins << " wins, "
+              << static_cast<double>(calls) / games << " open calls/game" << std::endl;
+}
+
+// Synthetic load on the session manager: one client keeps one command in
+// flight per expert session (random opens, a restart after each game) and
+// measures submit-to-result latency, for a growing number of sessions.
+void benchmarkSessions(double seconds) {
+    const std::size_t counts[] = {10, 100, 1000, 10000};
+    for (std::size_t count : counts) {
+        SessionManager manager(count);
+        std::vector<SessionManager::SessionId> ids(count);
+        std::vector<CommandResult> results(count);
+        std::vector<std::chrono::steady_clock::time_point> submitted(count);
+        SplitMix64 random(count);
+        for (std::size_t i = 0; i < count; ++i) {
+            ids[i] = manager.createSession(16, 30, 99, i + 1);
+            submitted[i] = std::chrono::steady_clock::now();
+            manager.submit(ids[i], {SESSION_OPEN, 8, 15}, results[i]);
+        }
+
+        std::vector<float> latencies; // microseconds
+        auto start = std::chrono::steady_clock::now();
+        while (secondsSince(start) < seconds) {
+            for (std::size_t i = 0; i < count; ++i) {
+                if (!results[i].ready()) {
+                    continue;
+                }
+                auto now = std::chrono::steady_clock::now();
+                latencies.push_back(std::chrono::duration<float, std::micro>(now - submitted[i]).count());
+                SessionCommand command = {SESSION_OPEN, static_cast<int>(random.nextBelow(16)), static_cast<int>(random.nextBelow(30))};
+                if (results[i].state != SESSION_PLAYING) {
+                    command.action = SESSION_RESTART;
+                }
+                results[i].reset();
+                submitted[i] = now;
+                manager.submit(ids[i], command, results[i]);
+            }
+        }
+        double elapsed = secondsSince(start);
+        for (CommandResult& result : results) {
+            result.wait(); // the slots must outlive the commands that write them
+        }
+
+        std::sort(latencies.begin(), latencies.end());
+        float p50 = latencies.empty() ? 0.0f : latencies[latencies.size() / 2];
+        float p99 = latencies.empty() ? 0.0f : latencies[latencies.size() * 99 / 100];
+        std::cout << "sessions: " << count << ", " << latencies.size() / elapsed << " commands/s, p50 " << p50
+                  << " us, p99 " << p99 << " us" << std::endl;
+    }
+}
+
+// What-if forks of a large board: each fork opens one random safe cell
+// and flags one random closed cell, as a solver branch would. Compares a
+// TiledField fork with a deep Field copy, and counts the tiles the forks
+// own between them.
+void benchmarkForks(int forks) {
+    const int side = 2048;
+    Field field(side, side, side * side * 15 / 100);
+    field.placeBombs(1, side / 2, side / 2);
+    field.calculateBombsNearby();
+    field.openCells(std::vector<std::pair<int, int>>(1, std::make_pair(side / 2, side / 2)));
+    TiledField base(field);
+
+    int copies = std::max(1, forks / 100);
+    auto start = std::chrono::steady_clock::now();
+    long long opened = 0;
+    for (int i = 0; i < copies; ++i) {
+        Field copy(field);
+        opened += copy.getCell(i % side, i % side).getOpen() ? 1 : 0;
+    }
+    double perCopy = secondsSince(start) / copies;
+
+    SplitMix64 random(7);
+    start = std::chrono::steady_clock::now();
+    std::vector<TiledField> states(forks, base);
+    for (TiledField& state : states) {
+        for (int tries = 0; tries < 64; ++tries) {
+            int row = static_cast<int>(random.nextBelow(side));
+            int col = static_cast<int>(random.nextBelow(side));
+            const Cell& cell = state.getCell(row, col);
+            if (!cell.getOpen() && !cell.getBomb()) {
+                opened += state.openCell(row, col).opened;
+                break;
+            }
+        }
+        state.flagCell(static_cast<int>(random.nextBelow(side)), static_cast<int>(random.nextBelow(side)));
+    }
+    double perFork = secondsSince(start) / forks;
+
+    std::size_t owned = 0;
+    for (const TiledField& state : states) {
+        owned += state.getPrivateTileCount();
+    }
+    double tileKiB = TiledField::TILE_SIZE * TiledField::TILE_SIZE * sizeof(Cell) / 1024.0;
+    std::cout << "Field copy: " << perCopy * 1e6 << " us, " << side * side * sizeof(Cell) / 1024 << " KiB" << std::endl;
+    std::cout << "TiledField fork + 2 moves: " << perFork * 1e6 << " us, " << static_cast<double>(owned) / forks
+              << " private tiles (" << static_cast<double>(owned) / forks * tileKiB << " KiB) per fork of "
+              << base.getTileCount() << ", " << opened << " cells opened" << std::endl;
+
+    UndoHistory history(forks);
+    TiledField game(base);
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < forks; ++i) {
+        history.checkpoint(game);
+        game.flagCell(static_cast<int>(random.nextBelow(side)), static_cast<int>(random.nextBelow(side)));
+    }
+    while (history.undo(game)) {
+    }
+    std::cout << "checkpoint + move + undo: " << secondsSince(start) / forks * 1e6 << " us" << std::endl;
+}
+
+// Counting, first-click flood and whole solver games for every topology,
+// so the square instantiations can be compared with the old fixed-stencil
+// code and the others with the square.
+void benchmarkTopology(int games) {
+    const TopologyKind kinds[] = {TOPOLOGY_SQUARE, TOPOLOGY_TORUS, TOPOLOGY_HEX};
+    const char* names[] = {"square", "torus", "hex"};
+    const int side = 2048;
+    for (int k = 0; k < 3; ++k) {
+        Field dense(side, side, side * side * 15 / 100, kinds[k]);
+        dense.placeBombs(1);
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < 10; ++i) {
+            dense.calculateBombsNearby();
+        }
+        double countNs = secondsSince(start) * 1e9 / (10.0 * side * side);
+
+        Field sparse(side, side, side * side / 100, kinds[k]);
+        sparse.placeBombs(2, side / 2, side / 2);
+        sparse.calculateBombsNearby();
+        std::vector<std::pair<int, int>> click(1, std::make_pair(side / 2, side / 2));
+        long long opened = 0;
+        double floodSeconds = 0.0;
+        for (int i = 0; i < 5; ++i) {
+            sparse.resetPlay();
+            start = std::chrono::steady_clock::now();
+            opened += sparse.openCells(click).opened;
+            floodSeconds += secondsSince(start);
+        }
+
+        Field field(16, 30, 99, kinds[k]);
+        int wins = 0;
+        start = std::chrono::steady_clock::now();
+        for (int game = 0; game < games; ++game) {
+            field.placeBombs(game + 1, 8, 15);
+            field.calculateBombsNearby();
+            wins += playGame(field).won ? 1 : 0;
+        }
+        double gamesPerSecond = games / secondsSince(start);
+
+        std::cout << names[k] << ": count " << countNs << " ns/cell, flood " << floodSeconds * 1e9 / opened
+                  << " ns/opened cell (" << opened / 5 << " cells), expert " << gamesPerSecond << " games/s, "
+                  << wins << "/" << games << " wins" << std::endl;
+    }
+}
+
+// Clicks spread over a 4096x4096 area of the endless board, so most of the
+// time goes into generating and counting the chunks they land in.
+void benchmarkChunked(int clicks) {
+    ChunkedField world(0.15, 1);
+    SplitMix64 random(2);
+    int made = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < clicks; ++i) {
+        long long row = static_cast<long long>(random.nextBelow(4096)) - 2048;
+        long long col = static_cast<long long>(random.nextBelow(4096)) - 2048;
+        const Cell& cell = world.getCell(row, col);
+        if (!cell.getOpen() && !cell.getFlagged() && !cell.getBomb()) {
+            world.openCell(row, col);
+            ++made;
+        }
+    }
+    double elapsed = secondsSince(start);
+    std::cout << "chunked: " << made << " clicks, " << world.getChunkCount() << " chunks, "
+              << world.getOpenedCells() << " cells opened, " << clicks / elapsed << " clicks/s, "
+              << elapsed * 1e6 / world.getChunkCount() << " us/chunk" << std::endl;
+}
+
+// A side x side game checkpointed every few hundred clicks: what a
+// checkpoint() stalls the game for (the first one also sizes the copy),
+// against a synchronous Snapshot::save and a load. A checkpoint taken while
+// the previous one is still being written is skipped.
+void benchmarkCheckpoint(int side, int checkpoints) {
+    const std::string path = "benchmark.snapshot";
+    Field field(side, side, static_cast<int>(static_cast<long long>(side) * side / 6));
+    field.placeBombs(11, side / 2, side / 2);
+    field.calculateBombsNearby();
+    field.openCell(side / 2, side / 2);
+
+    auto start = std::chrono::steady_clock::now();
+    bool saved = Snapshot::save(field, path);
+    double saveSeconds = secondsSince(start);
+    start = std::chrono::steady_clock::now();
+    Field loaded = Snapshot::load(path);
+    double loadSeconds = secondsSince(start);
+
+    SnapshotWriter writer(path);
+    SplitMix64 random(12);
+    double stalled = 0.0;
+    int taken = 0;
+    for (int i = 0; i < checkpoints; ++i) {
+        for (int click = 0; click < 256; ++click) {
+            int row = static_cast<int>(random.nextBelow(side));
+            int col = static_cast<int>(random.nextBelow(side));
+            const Cell& cell = field.getCell(row, col);
+            if (!cell.getOpen() && !cell.getBomb()) {
+                field.openCell(row, col);
+            }
+        }
+        start = std::chrono::steady_clock::now();
+        if (writer.checkpoint(field)) {
+            stalled += secondsSince(start);
+            ++taken;
+        }
+    }
+    saved = writer.wait() && saved;
+    std::remove(path.c_str());
+
+    std::cout << "checkpoint " << side << "x" << side << ": save " << saveSeconds * 1e3 << " ms, load "
+              << loadSeconds * 1e3 << " ms, checkpoint stall " << (taken > 0 ? stalled * 1e3 / taken : 0.0) << " ms ("
+              << taken << " of " << checkpoints << " taken)"
+              << (saved && loaded.getRows() == side ? "" : ", WRITE FAILED") << std::endl;
+}
+
+// Board generation and the first-click flood of a huge board, on one
+// thread and on `threads` (0 for every core), each checked against the
+// serial result.
+void benchmarkParallel(int side, int threads) {
+    std::size_t cells = static_cast<std::size_t>(side) * side;
+    Field serial(side, side, static_cast<int>(cells / 100));
+    Field parallel(side, side, static_cast<int>(cells / 100));
+
+    auto start = std::chrono::steady_clock::now();
+    serial.placeBombs(1, side / 2, side / 2);
+    double placeSerial = secondsSince(start);
+    start = std::chrono::steady_clock::now();
+    parallel.placeBombsParallel(1, side / 2, side / 2, threads);
+    double placeParallel = secondsSince(start);
+
+    start = std::chrono::steady_clock::now();
+    serial.calculateBombsNearby();
+    double countSerial = secondsSince(start);
+    Field counted(parallel);
+    counted.calculateBombsNearby();
+    start = std::chrono::steady_clock::now();
+    parallel.calculateBombsNearbyParallel(threads);
+    double countParallel = secondsSince(start);
+
+    start = std::chrono::steady_clock::now();
+    long long openedSerial = serial.openCells(std::vector<std::pair<int, int>>(1, std::make_pair(side / 2, side / 2))).opened;
+    double floodSerial = secondsSince(start);
+    start = std::chrono::steady_clock::now();
+    long long openedParallel = parallel.openCellParallel(side / 2, side / 2, threads).opened;
+    double floodParallel = secondsSince(start);
+    // The same click once more, with the labelling buffers already allocated.
+    parallel.resetPlay();
+    start = std::chrono::steady_clock::now();
+    parallel.openCellParallel(side / 2, side / 2, threads);
+    double floodAgain = secondsSince(start);
+    counted.openCells(std::vector<std::pair<int, int>>(1, std::make_pair(side / 2, side / 2)));
+
+    bool same = true;
+    for (int row = 0; row < side && same; ++row) {
+        for (int col = 0; col < side && same; ++col) {
+            same = counted.getCell(row, col).getBombsNearby() == parallel.getCell(row, col).getBombsNearby() &&
+                   counted.getCell(row, col).getOpen() == parallel.getCell(row, col).getOpen();
+        }
+    }
+
+    std::cout << side << "x" << side << ", " << (threads > 0 ? threads : static_cast<int>(std::thread::hardware_concurrency()))
+              << " threads" << std::endl;
+    std::cout << "place: " << placeSerial * 1e3 << " ms serial, " << placeParallel * 1e3 << " ms parallel" << std::endl;
+    std::cout << "count: " << countSerial * 1e3 << " ms serial, " << countParallel * 1e3 << " ms parallel" << std::endl;
+    std::cout << "first click: " << floodSerial * 1e3 << " ms serial (" << openedSerial << " cells), "
+              << floodParallel * 1e3 << " ms parallel (" << openedParallel << " cells), " << floodAgain * 1e3
+              << " ms parallel again" << std::endl;
+    std::cout << (same ? "parallel board matches serial" : "MISMATCH between parallel and serial") << std::endl;
+}
+
+}
+
+// Builds a position from a layout: 'F' flagged mine, '*' mine, 'o' open,
+// 'x' opened after the solver has stalled on the rest, '.' closed safe
+// cell. Returns true if the solver then finishes the game without a guess.
+bool solverFinishes(const char* const* layout, int rows) {
+    int cols = static_cast<int>(std::strlen(layout[0]));
+    int bombs = 0;
+    for (int row = 0; row < rows; ++row) {
+        for (int col = 0; col < cols; ++col) {
+            bombs += layout[row][col] == 'F' || layout[row][col] == '*' ? 1 : 0;
+        }
+    }
+    Field field(rows, cols, bombs);
+    field.placeBombs(1);
+    field.calculateBombsNearby();
+    std::vector<int> extra, missing;
+    for (int cell = 0; cell < rows * cols; ++cell) {
+        bool mine = layout[cell / cols][cell % cols] == 'F' || layout[cell / cols][cell % cols] == '*';
+        if (field.getCell(cell / cols, cell % cols).getBomb() != mine) {
+            (mine ? missing : extra).push_back(cell);
+        }
+    }
+    for (std::size_t i = 0; i < extra.size(); ++i) {
+        field.moveBomb(extra[i] / cols, extra[i] % cols, missing[i] / cols, missing[i] % cols);
+    }
+
+    std::pair<int, int> last(-1, -1);
+    for (int row = 0; row < rows; ++row) {
+        for (int col = 0; col < cols; ++col) {
+            if (layout[row][col] == 'F') {
+                field.flagCell(row, col);
+            }
+            else if (layout[row][col] == 'o') {
+                field.openCell(row, col);
+            }
+            else if (layout[row][col] == 'x') {
+                last = std::make_pair(row, col);
+            }
+        }
+    }
+    Solver solver(field);
+    if (solver.nextDeducedMove().row != -1) {
+        return false;
+    }
+    field.openCells(&last, 1);
+    solver.onCellsRevealed(field.getLastRevealed());
+    for (Move move = solver.nextDeducedMove(); move.row != -1 && !field.checkWin(); move = solver.nextDeducedMove()) {
+        field.openCell(move.row, move.col);
+        solver.onCellsRevealed(field.getLastRevealed());
+    }
+    return field.checkWin();
+}
+
+// The endless board across chunk borders: every count against the bombs
+// around the cell, the first click against a reference flood, and a flood
+// cut short by the reveal limit finished by clicking the zeros it left.
+bool checkChunkedField() {
+    const long long size = ChunkedField::CHUNK_SIZE;
+    bool passed = true;
+    for (std::uint64_t seed = 1; seed <= 10 && passed; ++seed) {
+        ChunkedField world(0.12, seed);
+        for (long long row = -2 * size; row < 2 * size && passed; ++row) {
+            for (long long col = -2 * size; col < 2 * size && passed; ++col) {
+                int bombs = 0;
+                for (long long r = row - 1; r <= row + 1; ++r) {
+                    for (long long c = col - 1; c <= col + 1; ++c) {
+                        bombs += (r != row || c != col) && world.getCell(r, c).getBomb() ? 1 : 0;
+                    }
+                }
+                const Cell& cell = world.getCell(row, col);
+                passed = cell.getBomb() || cell.getBombsNearby() == bombs;
+            }
+        }
+
+        // Reference: the zero region of the origin and everything around it.
+        std::set<std::pair<long long, long long>> region;
+        std::vector<std::pair<long long, long long>> stack;
+        stack.push_back(std::make_pair(0LL, 0LL));
+        region.insert(stack.back());
+        while (!stack.empty()) {
+            std::pair<long long, long long> cell = stack.back();
+            stack.pop_back();
+            if (world.getCell(cell.first, cell.second).getBombsNearby() != 0) {
+                continue;
+            }
+            for (long long r = cell.first - 1; r <= cell.first + 1; ++r) {
+                for (long long c = cell.second - 1; c <= cell.second + 1; ++c) {
+                    if (region.insert(std::make_pair(r, c)).second) {
+                        stack.push_back(std::make_pair(r, c));
+                    }
+                }
+            }
+        }
+        world.openCell(0, 0);
+        passed = passed && !world.isExploded() && world.getOpenedCells() == static_cast<long long>(region.size());
+        for (const std::pair<long long, long long>& cell : region) {
+            passed = passed && world.getCell(cell.first, cell.second).getOpen();
+        }
+
+        ChunkedField limited(0.12, seed);
+        limited.setRevealLimit(16);
+        std::vector<std::pair<long long, long long>> clicks;
+        clicks.push_back(std::make_pair(0LL, 0LL));
+        for (int rounds = 0; !clicks.empty() && passed && rounds < 100000; ++rounds) {
+            limited.openCell(clicks.back().first, clicks.back().second);
+            clicks.clear();
+            for (const std::pair<long long, long long>& cell : region) {
+                const Cell& opened = limited.getCell(cell.first, cell.second);
+                if (!opened.getOpen() || opened.getBombsNearby() != 0) {
+                    continue;
+                }
+                for (long long r = cell.first - 1; r <= cell.first + 1 && passed; ++r) {
+                    for (long long c = cell.second - 1; c <= cell.second + 1; ++c) {
+                        const Cell& next = limited.getCell(r, c);
+                        if (!next.getOpen()) {
+                            passed = next.getBombsNearby() == 0 && !next.getBomb();
+                            clicks.assign(1, std::make_pair(r, c));
+                        }
+                    }
+                }
+            }
+        }
+        passed = passed && limited.getOpenedCells() == static_cast<long long>(region.size());
+    }
+    std::cout << "chunked board counts and floods across chunk borders: " << (passed ? "ok" : "FAILED") << std::endl;
+    return passed;
+}
+
+bool sameCells(const Field& a, const Field& b) {
+    for (int row = 0; row < a.getRows(); ++row) {
+        for (int col = 0; col < a.getCols(); ++col) {
+            if (std::memcmp(&a.getCell(row, col), &b.getCell(row, col), sizeof(Cell)) != 0) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+// Boards of every topology and placement, mid-game, through Snapshot::save
+// and SnapshotWriter and back: same cells and state, and the loaded board
+// plays on like the original. A truncated file must be refused.
+bool checkSnapshot() {
+    const std::string path = "benchmark.snapshot";
+    SplitMix64 random(11);
+    bool passed = true;
+    SnapshotWriter writer(path);
+    for (int board = 0; board < 12 && passed; ++board) {
+        int rows = 5 + static_cast<int>(random.nextBelow(60));
+        int cols = 5 + static_cast<int>(random.nextBelow(60));
+        Field field(rows, cols, rows * cols / 8, static_cast<TopologyKind>(board % 3));
+        if (board % 2 == 0) {
+            field.placeBombs(board, rows / 2, cols / 2);
+        }
+        else {
+            field.placeBombsParallel(board, rows / 2, cols / 2, 2);
+        }
+        field.calculateBombsNearby();
+        field.openCell(rows / 2, cols / 2);
+        for (int flags = 0; flags < 5; ++flags) {
+            int row = static_cast<int>(random.nextBelow(rows));
+            int col = static_cast<int>(random.nextBelow(cols));
+            if (!field.getCell(row, col).getOpen()) {
+                field.flagCell(row, col);
+            }
+        }
+
+        bool written = board % 4 < 2 ? Snapshot::save(field, path) : writer.checkpoint(field) && writer.wait();
+        Field loaded = Snapshot::load(path);
+        passed = written && sameCells(field, loaded) && loaded.getTopology() == field.getTopology() &&
+                 loaded.getTotalBombs() == field.getTotalBombs() && loaded.getSeed() == field.getSeed() &&
+                 loaded.getSafeCell() == field.getSafeCell() && loaded.getPlacement() == field.getPlacement() &&
+                 loaded.isExploded() == field.isExploded();
+
+        // Opening every remaining safe cell wins both boards on the same move.
+        for (int cell = 0; cell < rows * cols && passed; ++cell) {
+            const Cell& state = field.getCell(cell / cols, cell % cols);
+            if (!state.getOpen() && !state.getFlagged() && !state.getBomb()) {
+                field.openCell(cell / cols, cell % cols);
+                loaded.openCell(cell / cols, cell % cols);
+                passed = sameCells(field, loaded) && loaded.checkWin() == field.checkWin();
+            }
+        }
+    }
+
+    // Cut the cells short: load must throw instead of mapping past the end.
+    if (passed) {
+        Field field(64, 64, 500);
+        field.placeBombs(1);
+        passed = Snapshot::save(field, path) && truncate(path.c_str(), Snapshot::CELLS_OFFSET + 64 * 64 - 1) == 0;
+        bool refused = false;
+        try {
+            Snapshot::load(path);
+        }
+        catch (const std::runtime_error&) {
+            refused = true;
+        }
+        passed = passed && refused;
+    }
+    std::remove(path.c_str());
+    std::cout << "snapshots round-trip on 12 boards, truncated file refused: " << (passed ? "ok" : "FAILED")
+              << std::endl;
+    return passed;
+}
+
+// openCells and chord against openCell called on the same cells one at a
+// time, on random boards of every topology with random flags, with and
+// without a zero-region index.
+bool checkBatchOpen() {
+    SplitMix64 random(7);
+    bool passed = true;
+    for (int board = 0; board < 3000 && passed; ++board) {
+        int rows = 1 + static_cast<int>(random.nextBelow(30));
+        int cols = 1 + static_cast<int>(random.nextBelow(30));
+        int bombs = static_cast<int>(random.nextBelow(rows * cols / 4 + 1));
+        Field sequential(rows, cols, bombs, static_cast<TopologyKind>(board % 3));
+        sequential.placeBombs(board + 1);
+        sequential.calculateBombsNearby();
+        if (board % 2 == 1) {
+            sequential.indexZeroRegions();
+        }
+        for (int flags = static_cast<int>(random.nextBelow(6)); flags > 0; --flags) {
+            sequential.flagCell(static_cast<int>(random.nextBelow(rows)), static_cast<int>(random.nextBelow(cols)));
+        }
+        Field batched(sequential);
+
+        // A batch with repeats, flagged cells and maybe bombs in it. Its
+        // skipped count differs by design: the batch floods once at the end,
+        // so a seed inside another seed's zero region is not open yet when
+        // the batch reaches it.
+        std::vector<std::pair<int, int>> batch;
+        for (int seeds = 1 + static_cast<int>(random.nextBelow(8)); seeds > 0; --seeds) {
+            batch.push_back(std::make_pair(static_cast<int>(random.nextBelow(rows)), static_cast<int>(random.nextBelow(cols))));
+        }
+        OpenStatus status = batched.openCells(batch);
+        long long opened = 0;
+        std::pair<int, int> firstBomb(-1, -1);
+        for (const std::pair<int, int>& seed : batch) {
+            const Cell& cell = sequential.getCell(seed.first, seed.second);
+            if (cell.getOpen() || cell.getFlagged()) {
+                continue;
+            }
+            if (cell.getBomb() && firstBomb.first == -1) {
+                firstBomb = seed;
+            }
+            sequential.openCell(seed.first, seed.second);
+        }
+        for (int cell = 0; cell < rows * cols; ++cell) {
+            const Cell& state = sequential.getCell(cell / cols, cell % cols);
+            opened += state.getOpen() && !state.getBomb() ? 1 : 0;
+        }
+        passed = sameCells(sequential, batched) && status.opened == opened &&
+                 status.exploded == sequential.isExploded() && status.bombRow == firstBomb.first &&
+                 status.bombCol == firstBomb.second;
+        if (!passed || sequential.isExploded()) {
+            continue;
+        }
+
+        // Chord some open numbers after flagging the bombs around them.
+        for (int cell = 0; cell < rows * cols && passed; ++cell) {
+            int row = cell / cols;
+            int col = cell % cols;
+            const Cell& centre = sequential.getCell(row, col);
+            if (!centre.getOpen() || centre.getBombsNearby() == 0 || random.nextBelow(3) != 0) {
+                continue;
+            }
+            std::vector<std::pair<int, int>> around;
+            withTopology(sequential.getTopology(), [&](auto policy) {
+                decltype(policy)::forEachNeighbour(row, col, rows, cols, [&around](int r, int c) {
+                    around.push_back(std::make_pair(r, c));
+                });
+            });
+            // A wrong chord moves one flag off a bomb onto a closed safe cell.
+            std::pair<int, int> unflaggedBomb(-1, -1);
+            std::pair<int, int> flaggedSafe(-1, -1);
+            if (random.nextBelow(4) == 0) {
+                for (const std::pair<int, int>& next : around) {
+                    const Cell& state = sequential.getCell(next.first, next.second);
+                    if (state.getBomb() && unflaggedBomb.first == -1) {
+                        unflaggedBomb = next;
+                    }
+                    else if (!state.getBomb() && !state.getOpen() && flaggedSafe.first == -1) {
+                        flaggedSafe = next;
+                    }
+                }
+            }
+            for (const std::pair<int, int>& next : around) {
+                const Cell& state = sequential.getCell(next.first, next.second);
+                bool flag = (state.getBomb() && next != unflaggedBomb) || next == flaggedSafe;
+                if (!state.getOpen() && state.getFlagged() != flag) {
+                    sequential.flagCell(next.first, next.second);
+                    batched.flagCell(next.first, next.second);
+                }
+            }
+            int flags = 0;
+            for (const std::pair<int, int>& next : around) {
+                flags += sequential.getCell(next.first, next.second).getFlagged() ? 1 : 0;
+            }
+            long long openedBefore = 0;
+            for (int i = 0; i < rows * cols; ++i) {
+                const Cell& state = sequential.getCell(i / cols, i % cols);
+                openedBefore += state.getOpen() && !state.getBomb() ? 1 : 0;
+            }
+            OpenStatus chorded = batched.chord(row, col);
+            if (flags != centre.getBombsNearby()) {
+                passed = chorded.refused && sameCells(sequential, batched);
+                continue;
+            }
+            for (const std::pair<int, int>& next : around) {
+                const Cell& state = sequential.getCell(next.first, next.second);
+                if (!state.getOpen() && !state.getFlagged()) {
+                    sequential.openCell(next.first, next.second);
+                }
+            }
+            long long openedAfter = 0;
+            for (int i = 0; i < rows * cols; ++i) {
+                const Cell& state = sequential.getCell(i / cols, i % cols);
+                openedAfter += state.getOpen() && !state.getBomb() ? 1 : 0;
+            }
+            passed = !chorded.refused && sameCells(sequential, batched) && chorded.opened == openedAfter - openedBefore &&
+                     chorded.exploded == sequential.isExploded();
+            if (sequential.isExploded()) {
+                break;
+            }
+        }
+    }
+    std::cout << "batch open and chord match sequential openCell calls on 3000 boards: " << (passed ? "ok" : "FAILED")
+              << std::endl;
+    return passed;
+}
+
+template <int R, int C>
+bool sameAsFixed(const Field& field, const FixedField<R, C>& fixed) {
+    for (int row = 0; row < R; ++row) {
+        for (int col = 0; col < C; ++col) {
+            if (std::memcmp(&field.getCell(row, col), &fixed.getCell(row, col), sizeof(Cell)) != 0) {
+                return false;
+            }
+        }
+    }
+    const std::vector<RevealedSpan>& spans = field.getLastRevealed();
+    RevealedRange fixedSpans = fixed.getLastRevealed();
+    if (spans.size() != fixedSpans.size()) {
+        return false;
+    }
+    for (std::size_t i = 0; i < spans.size(); ++i) {
+        const RevealedSpan& span = fixedSpans.begin()[i];
+        if (spans[i].row != span.row || spans[i].firstCol != span.firstCol || spans[i].lastCol != span.lastCol) {
+            return false;
+        }
+    }
+    return field.isExploded() == fixed.isExploded() && field.checkWin() == fixed.checkWin();
+}
+
+bool sameStatus(const OpenStatus& a, const OpenStatus& b) {
+    return a.opened == b.opened && a.skipped == b.skipped && a.exploded == b.exploded && a.bombRow == b.bombRow &&
+           a.bombCol == b.bombCol && a.refused == b.refused;
+}
+
+// One preset of checkFixedField: seeds boards of random density, with and
+// without a safe first click, played with random flags, clicks, batches
+// and chords, then once more by the solver when no denser than expert.
+template <int R, int C>
+bool checkFixedPreset(int seeds, SplitMix64& random) {
+    for (int seed = 0; seed < seeds; ++seed) {
+        int bombs = static_cast<int>(random.nextBelow(R * C));
+        int safeRow = seed % 4 == 0 ? -1 : static_cast<int>(random.nextBelow(R));
+        int safeCol = seed % 4 == 0 ? -1 : static_cast<int>(random.nextBelow(C));
+        Field field(R, C, bombs);
+        FixedField<R, C> fixed(bombs);
+        field.placeBombs(seed, safeRow, safeCol);
+        fixed.placeBombs(seed, safeRow, safeCol);
+        field.calculateBombsNearby();
+        fixed.calculateBombsNearby();
+        if (!sameAsFixed(field, fixed)) {
+            return false;
+        }
+
+        for (int step = 0; step < 40 && !field.isExploded() && !field.checkWin(); ++step) {
+            int row = static_cast<int>(random.nextBelow(R));
+            int col = static_cast<int>(random.nextBelow(C));
+            const Cell& cell = field.getCell(row, col);
+            int action = static_cast<int>(random.nextBelow(8));
+            if (action == 0 && !cell.getOpen()) {
+                field.flagCell(row, col);
+                fixed.flagCell(row, col);
+            }
+            else if (action < 4 && !cell.getOpen() && !cell.getFlagged() && !cell.getBomb()) {
+                field.openCell(row, col);
+                fixed.openCell(row, col);
+            }
+            else if (action < 6) {
+                std::vector<std::pair<int, int>> batch;
+                for (int seeds = 1 + static_cast<int>(random.nextBelow(6)); seeds > 0; --seeds) {
+                    batch.push_back(std::make_pair(static_cast<int>(random.nextBelow(R + 2)) - 1,
+                                                   static_cast<int>(random.nextBelow(C + 2)) - 1));
+                }
+                if (!sameStatus(field.openCells(batch), fixed.openCells(batch))) {
+                    return false;
+                }
+            }
+            else if (!sameStatus(field.chord(row, col), fixed.chord(row, col))) {
+                return false;
+            }
+            if (!sameAsFixed(field, fixed)) {
+                return false;
+            }
+        }
+
+        if (bombs > R * C / 5) {
+            continue; // dense boards are all guesses; they cost time and check nothing new
+        }
+        field.placeBombs(seed, R / 2, C / 2);
+        fixed.placeBombs(seed, R / 2, C / 2);
+        field.calculateBombsNearby();
+        fixed.calculateBombsNearby();
+        GameResult dynamicGame = playGame(field);
+        GameResult fixedGame = playGame(fixed);
+        if (dynamicGame.won != fixedGame.won || dynamicGame.moves != fixedGame.moves ||
+            dynamicGame.guesses != fixedGame.guesses || !sameAsFixed(field, fixed)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// FixedField against Field on the three presets: the same seed must give
+// the same board, and the same moves the same cells, spans and statuses.
+bool checkFixedField() {
+    SplitMix64 random(18);
+    bool passed = checkFixedPreset<9, 9>(8000, random) && checkFixedPreset<16, 16>(6000, random) &&
+                  checkFixedPreset<16, 30>(6000, random);
+    std::cout << "FixedField matches Field on 20000 seeds of the three presets: " << (passed ? "ok" : "FAILED")
+              << std::endl;
+    return passed;
+}
+
+// calculateBombsNearby and calculateBombsNearbyParallel against a plain
+// count of each cell's neighbours, on random boards of every topology.
+// Odd widths and sizes around the vector width exercise the tails of the
+// box sums; thin boards make the torus wrap onto itself.
+bool checkBombCounts() {
+    SplitMix64 random(3);
+    bool passed = true;
+    for (int board = 0; board < 600 && passed; ++board) {
+        int rows = 1 + static_cast<int>(random.nextBelow(board % 5 == 0 ? 3 : 70));
+        int cols = 1 + static_cast<int>(random.nextBelow(board % 7 == 0 ? 3 : 70));
+        int bombs = static_cast<int>(random.nextBelow(rows * cols + 1));
+        TopologyKind topology = static_cast<TopologyKind>(board % 3);
+        Field field(rows, cols, bombs, topology);
+        field.placeBombs(board);
+        Field parallel(field);
+        field.calculateBombsNearby();
+        parallel.calculateBombsNearbyParallel(1 + board % 4);
+        withTopology(topology, [&](auto policy) {
+            for (int row = 0; row < rows && passed; ++row) {
+                for (int col = 0; col < cols && passed; ++col) {
+                    const Cell& cell = field.getCell(row, col);
+                    if (cell.getBomb()) {
+                        continue;
+                    }
+                    int count = 0;
+                    decltype(policy)::forEachNeighbour(row, col, rows, cols, [&field, &count](int r, int c) {
+                        count += field.getCell(r, c).getBomb() ? 1 : 0;
+                    });
+                    passed = cell.getBombsNearby() == count && parallel.getCell(row, col).getBombsNearby() == count;
+                }
+            }
+        });
+    }
+    std::cout << "box-sum counts match a per-cell count on 600 square, torus and hex boards: "
+              << (passed ? "ok" : "FAILED") << std::endl;
+    return passed;
+}
+
+// Session ids across slot reuse, and blocking waits. A one-slot manager
+// closes a session and hands the slot out again: the old id must be
+// refused and must not close the new session. Then four threads submit
+// and wait() on their own commands until each has played 200.
+bool checkSessions() {
+    SessionManager manager(1, 2);
+    CommandResult opened;
+    SessionManager::SessionId first = manager.createSession(9, 9, 10, 1);
+    bool passed = manager.submit(first, {SESSION_OPEN, 4, 4}, opened);
+    opened.wait();
+    passed = passed && opened.applied;
+    manager.closeSession(first);
+
+    SessionManager::SessionId second;
+    while ((second = manager.createSession(9, 9, 10, 2)) == static_cast<SessionManager::SessionId>(-1)) {
+        std::this_thread::yield(); // the slot comes back once a worker has released the board
+    }
+    CommandResult stale;
+    passed = passed && second != first && (second & 0xFFFFFFFFu) == (first & 0xFFFFFFFFu) &&
+             !manager.submit(first, {SESSION_FLAG, 0, 0}, stale) && !stale.ready();
+    manager.closeSession(first);
+    CommandResult flagged;
+    passed = passed && manager.submit(second, {SESSION_FLAG, 0, 0}, flagged);
+    flagged.wait();
+    passed = passed && flagged.applied;
+    manager.closeSession(second);
+
+    SessionManager shared(4, 2);
+    std::atomic<int> failures(0);
+    std::vector<std::thread> players;
+    for (int player = 0; player < 4; ++player) {
+        players.emplace_back([&shared, &failures, player] {
+            SessionManager::SessionId id = shared.createSession(16, 30, 99, player + 1);
+            SplitMix64 random(player);
+            CommandResult result;
+            for (int command = 0; command < 200; ++command) {
+                SessionCommand next = {SESSION_OPEN, static_cast<int>(random.nextBelow(16)),
+                                       static_cast<int>(random.nextBelow(30))};
+                if (result.state != SESSION_PLAYING) {
+                    next.action = SESSION_RESTART;
+                }
+                result.reset();
+                if (!shared.submit(id, next, result)) {
+                    ++failures;
+                    return;
+                }
+                result.wait();
+            }
+        });
+    }
+    for (std::thread& player : players) {
+        player.join();
+    }
+    passed = passed && failures == 0;
+    std::cout << "session ids survive slot reuse, blocking waits complete: " << (passed ? "ok" : "FAILED")
+              << std::endl;
+    return passed;
+}
+
+// The pool never holds more than its capacity, and a pool whose every
+// attempt fails gives up instead of leaving take() blocked for ever.
+bool checkNoGuessPool() {
+    Field board(9, 9, 10);
+    bool passed = true;
+    {
+        NoGuessPool pool(9, 9, 10, 1, 2, 3);
+        for (int i = 0; i < 20 && passed; ++i) {
+            passed = pool.takeFor(board, std::chrono::seconds(10)) && pool.available() <= 2;
+        }
+        for (int wait = 0; wait < 100 && passed; ++wait) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            passed = pool.available() <= 2;
+        }
+    }
+    {
+        // One mine among the three cells around the click on a 2x2 board:
+        // always a guess, and every closed cell touches the open one, so
+        // there is nowhere to move the mine to.
+        NoGuessPool pool(2, 2, 1, 1, 2, 2, 20);
+        passed = passed && !pool.take(board) && !pool.takeFor(board, std::chrono::milliseconds(1));
+    }
+    std::cout << "no-guess pool stays within capacity, gives up on impossible boards: "
+              << (passed ? "ok" : "FAILED") << std::endl;
+    return passed;
+}
+
+// Positions that pin down solver paths.
+bool checkBoards() {
+    // Opening x leaves (2,2) with the cells (2,3) and (3,3), a subset of
+    // both (2,4) and (3,2). Examining (2,2) fires the rule against (2,4)
+    // first, which only changes cells around (2,4); the pair with (3,2)
+    // must still be looked at.
+    const char* smallSide[] = {
+        "FFFFFFF",
+        "FxFFF.F",
+        "FFo*o.F",
+        "FFo.FFF",
+        "FF..FFF",
+        "FFFFFFF",
+    };
+    bool passed = solverFinishes(smallSide, 6);
+    std::cout << "subset rule, examined number on the small side: " << (passed ? "ok" : "FAILED") << std::endl;
+    passed = checkBombCounts() && passed;
+    passed = checkChunkedField() && passed;
+    passed = checkSnapshot() && passed;
+    passed = checkSessions() && passed;
+    passed = checkNoGuessPool() && passed;
+    passed = checkBatchOpen() && passed;
+    passed = checkFixedField() && passed;
+    return passed;
+}
+
+int main(int argc, char* argv[]) {
+    const char* mode = argc > 1 ? argv[1] : "probability";
+
+    if (std::strcmp(mode, "probability") == 0) {
+        benchmarkProbability(argc > 2 ? std::atoi(argv[2]) : 2000);
+    }
+    else if (std::strcmp(mode, "simulate") == 0) {
+        benchmarkSimulation(argc > 2 ? std::atoi(argv[2]) : 10000);
+    }
+    else if (std::strcmp(mode, "farm") == 0) {
+        benchmarkFarm(argc > 2 ? std::atoll(argv[2]) : 20000);
+    }
+    else if (std::strcmp(mode, "render") == 0) {
+        benchmarkRender(argc > 2 ? std::atoi(argv[2]) : 2000);
+    }
+    else if (std::strcmp(mode, "analyze") == 0) {
+        benchmarkAnalyzer(argc > 2 ? std::atoi(argv[2]) : 10000);
+    }
+    else if (std::strcmp(mode, "noguess") == 0) {
+        benchmarkNoGuess(argc > 2 ? std::atoi(argv[2]) : 2000);
+    }
+    else if (std::strcmp(mode, "replay") == 0) {
+        benchmarkReplay(argc > 2 ? std::atoi(argv[2]) : 1000);
+    }
+    else if (std::strcmp(mode, "hotpaths") == 0) {
+        benchmarkHotPaths(argc > 2 ? argv[2] : "hotpaths.json", argc > 3 ? std::atoi(argv[3]) : 1024);
+    }
+    else if (std::strcmp(mode, "fixed") == 0) {
+        benchmarkFixed(argc > 2 ? std::atoi(argv[2]) : 200000);
+    }
+    else if (std::strcmp(mode, "batch") == 0) {
+        benchmarkBatchOpen(argc > 2 ? std::atoi(argv[2]) : 5000);
+    }
+    else if (std::strcmp(mode, "sessions") == 0) {
+        benchmarkSessions(argc > 2 ? std::atof(argv[2]) : 2.0);
+    }
+    else if (std::strcmp(mode, "forks") == 0) {
+        benchmarkForks(argc > 2 ? std::atoi(argv[2]) : 5000);
+    }
+    else if (std::strcmp(mode, "topology") == 0) {
+        benchmarkTopology(argc > 2 ? std::atoi(argv[2]) : 2000);
+    }
+    else if (std::strcmp(mode, "parallel") == 0) {
+        benchmarkParallel(argc > 2 ? std::atoi(argv[2]) : 8192, argc > 3 ? std::atoi(argv[3]) : 0);
+    }
+    else if (std::strcmp(mode, "chunked") == 0) {
+        benchmarkChunked(argc > 2 ? std::atoi(argv[2]) : 20000);
+    }
+    else if (std::strcmp(mode, "checkpoint") == 0) {
+        benchmarkCheckpoint(argc > 2 ? std::atoi(argv[2]) : 4096, argc > 3 ? std::atoi(argv[3]) : 50);
+    }
+    else if (std::strcmp(mode, "boards") == 0) {
+        if (!checkBoards()) {
+            return 1;
+        }
+    }
+    else {
+        std::cerr << "Unknown benchmark: " << mode << std::endl;
+        return 1;
+    }
+    if (FieldStats::isEnabled()) {
+        std::cerr << FieldStats::snapshot().toJson() << std::endl;
+    }
+    return 0;
+}
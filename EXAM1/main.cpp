@@ -1,35 +1,49 @@
+#include <cstdint>
 #include <iostream>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
 #include "Field.h"
+#include "GameFarm.h"
+#include "Journal.h"
 
 int main() {
     int rows, cols, numBombs;
     std::cout << "Enter number of rows, columns, and bombs: ";
     std::cin >> rows >> cols >> numBombs;
 
-    if (numBombs >= rows * cols) {
+    if (numBombs >= static_cast<long long>(rows) * cols) {
         std::cerr << "Number of bombs should be less than the number of cells." << std::endl;
         return 1;
     }
 
     Field field(rows, cols, numBombs);
-    field.placeBombs();
-    field.calculateBombsNearby();
 
     char choice;
-    std::cout << "Do you want to watch the autoplay (a) or play manually (m)? ";
+    std::cout << "Do you want to watch the autoplay (a), play manually (m) or simulate many games (s)? ";
     std::cin >> choice;
 
     if (choice == 'a') {
+        field.placeBombs();
+        field.calculateBombsNearby();
         field.autoplay();
     }
     else if (choice == 'm') {
+        std::random_device rd;
+        std::uint64_t seed = (static_cast<std::uint64_t>(rd()) << 32) | rd();
+        std::string journalPath;
+        std::cout << "Record the game to a journal file for replay? Enter its path, or '-' for no journal: ";
+        std::cin >> journalPath;
+        MoveJournal journal;
+        bool bombsPlaced = false;
         bool gameOver = false;
         while (!gameOver) {
             field.displayField(false);
 
             char action;
             int selectedRow, selectedCol;
-            std::cout << "Enter 'o' to open a cell or 'f' to flag/unflag a cell: ";
+            std::cout << "Enter 'o' to open a cell, 'f' to flag/unflag a cell or 'c' to chord a number: ";
             std::cin >> action >> selectedRow >> selectedCol;
 
             if (selectedRow < 0 || selectedRow >= rows || selectedCol < 0 || selectedCol >= cols) {
@@ -38,13 +52,47 @@ int main() {
             }
 
             if (action == 'o') {
-                gameOver = !field.openCell(selectedRow, selectedCol);
+                if (!bombsPlaced) {
+                    // The board is generated on the first click so that it is never a bomb.
+                    // Placing resets every cell, so flags set before it are put back,
+                    // after the journal is attached so that it records them too.
+                    std::vector<std::pair<int, int>> flags;
+                    for (int r = 0; r < rows; ++r) {
+                        for (int c = 0; c < cols; ++c) {
+                            if (field.getCell(r, c).getFlagged()) {
+                                flags.emplace_back(r, c);
+                            }
+                        }
+                    }
+                    field.placeBombs(seed, selectedRow, selectedCol);
+                    field.calculateBombsNearby();
+                    if (journalPath != "-") {
+                        field.setJournal(&journal);
+                        if (!journal.attachFile(journalPath)) {
+                            std::cerr << "Cannot write the journal to " << journalPath << "; playing without one." << std::endl;
+                            field.setJournal(nullptr);
+                        }
+                    }
+                    for (const std::pair<int, int>& flag : flags) {
+                        field.flagCell(flag.first, flag.second);
+                    }
+                    bombsPlaced = true;
+                }
+                field.openCell(selectedRow, selectedCol); // false for a flagged or open cell as well as a bomb
+                gameOver = field.isExploded();
             }
             else if (action == 'f') {
                 field.flagCell(selectedRow, selectedCol);
             }
+            else if (action == 'c') {
+                OpenStatus status = field.chord(selectedRow, selectedCol);
+                if (status.refused) {
+                    std::cerr << "Chord needs an open number with that many flags around it." << std::endl;
+                }
+                gameOver = status.exploded;
+            }
             else {
-                std::cerr << "Invalid action. Use 'o' to open or 'f' to flag." << std::endl;
+                std::cerr << "Invalid action. Use 'o' to open, 'f' to flag or 'c' to chord." << std::endl;
             }
 
             if (gameOver) {
@@ -58,6 +106,19 @@ int main() {
             }
         }
     }
+    else if (choice == 's') {
+        long long games;
+        int threads;
+        std::cout << "Enter number of games and threads (0 for all cores): ";
+        std::cin >> games >> threads;
+
+        std::random_device rd;
+        FarmConfig config = {rows, cols, numBombs, (static_cast<std::uint64_t>(rd()) << 32) | rd(), games, threads, 64};
+        SimulationStats stats = runGameFarm(config);
+        std::cout << "Games: " << stats.games << ", won: " << stats.wins << " (" << stats.winRate() * 100 << "%)" << std::endl;
+        std::cout << "Moves per game: " << stats.movesPerGame() << ", guesses per game: " << stats.guessesPerGame() << std::endl;
+        std::cout << "Time per game: " << stats.secondsPerGame() * 1000 << " ms" << std::endl;
+    }
     else {
         std::cerr << "Invalid choice. Exiting..." << std::endl;
         return 1;
@@ -6,7 +6,7 @@
 using namespace std;
 
 
-int josephus(Vector warriors, int step) {
+int josephus(Vector<int> warriors, int step) {
     int remaining_warriors = warriors.getSize();
     int current_index = step - 1;
     while (remaining_warriors > 1) {
@@ -21,13 +21,13 @@ int main(){
     setlocale(LC_ALL, "Ru");
     int n = 10000;
     int k = 2;
-    Vector v1(n);
+    Vector<int> v1(n);
     for (int i = 1; i <= n; i++){
         v1.push_back(i);
     }
 
     auto start = std::chrono::high_resolution_clock::now();
-    int last_survivor = josephus(v1, k);
+    int last_survivor = josephus(std::move(v1), k); // без копии: v1 больше не нужен
     auto end = std::chrono::high_resolution_clock::now();
     std::chrono::duration<double> duration = end - start;
 
@@ -1,7 +1,7 @@
 #ifndef LINELIST_H
 #define LINELIST_H
 
-#include "../vector/vector.h" // Подключаем определение класса Vector
+#include "../Vector/Vector.h" // Подключаем определение класса Vector
 
 #include <iostream>
 
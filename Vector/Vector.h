@@ -3,7 +3,13 @@
 #ifndef VECTOR_VECTOR_H
 #define VECTOR_VECTOR_H
 
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
 #include <iostream>
+#include <new>
+#include <type_traits>
+#include <utility>
 
 using namespace std;
 
@@ -29,38 +35,425 @@ class ArrayException{
 const int DEFAULT_CAPACITY = 10;
 const int DEFAULT_MAX_SIZE = 10;
 
+// Динамический массив элементов типа T.
+// Память выделяется без конструирования: элементы создаются placement new
+// только в ячейках [0, size), поэтому T не обязан иметь конструктор по
+// умолчанию. Если при росте массива конструктор бросает исключение,
+// вектор остаётся в прежнем состоянии.
+// Для тривиально копируемых T элементы переносятся memcpy/memmove, а память
+// берётся из malloc, чтобы при росте realloc мог расширить блок на месте
+// (большие блоки glibc переносит через mremap, без копирования).
+template <typename T>
 class Vector {
 private:
-    int* ptr;
+    T* ptr;
     int size;
     int maxSize = DEFAULT_MAX_SIZE;
     int capacity;
 
+    // Элементы можно переносить побайтно, а память брать из malloc
+    static constexpr bool RELOCATABLE = is_trivially_copyable<T>::value &&
+                                        alignof(T) <= alignof(max_align_t);
+
+    static T* allocate(int count);
+    static void deallocate(T* memory);
+    static void destroy(T* first, int count);
+    // Переносит count элементов в неинициализированную память to. Перемещает,
+    // если перемещение не бросает, иначе копирует; при исключении уже
+    // созданные копии уничтожаются, а from не меняется.
+    static void moveElements(T* from, int count, T* to);
+
+    int grownCapacity(int newCapacity) const;
+    void release();
+
 public:
     explicit Vector(int startCapacity=DEFAULT_CAPACITY);
-    Vector(int initialSize, int initialValue);
+    Vector(int initialSize, const T& initialValue);
     ~Vector();
     Vector(const Vector &arr);
+    Vector(Vector &&arr) noexcept;
 
     Vector& operator =(const Vector& arr);
+    Vector& operator =(Vector&& arr) noexcept;
     bool operator ==(const Vector& other) const;
     bool operator !=(const Vector& other) const;
-    int& operator [](int index);
+    T& operator [](int index);
+    const T& operator [](int index) const;
 
-    int getSize();
-    int getCapacity();
+    int getSize() const;
+    int getCapacity() const;
 
-    bool isEmpty();
+    bool isEmpty() const;
     void clear();
+    void swap(Vector& other) noexcept;
 
     void increaseCapacity(int newCapacity);
-    void push_back(int element);
+    void push_back(const T& element);
+    void push_back(T&& element);
+    template <typename... Args>
+    T& emplace_back(Args&&... args);
     void pop_back();
     void remove(int index);
 
 
-    friend ostream& operator <<(ostream& out, const Vector& arr);
+    template <typename U>
+    friend ostream& operator <<(ostream& out, const Vector<U>& arr);
 };
 
 
+template <typename T>
+T* Vector<T>::allocate(int count)
+{
+    if (count <= 0)
+        return nullptr;
+    if constexpr (RELOCATABLE) {
+        void* memory = std::malloc(sizeof(T) * static_cast<size_t>(count));
+        if (!memory)
+            throw std::bad_alloc();
+        return static_cast<T*>(memory);
+    }
+    else
+        return static_cast<T*>(::operator new(sizeof(T) * static_cast<size_t>(count)));
+}
+
+template <typename T>
+void Vector<T>::deallocate(T* memory)
+{
+    if constexpr (RELOCATABLE)
+        std::free(memory);
+    else
+        ::operator delete(memory);
+}
+
+template <typename T>
+void Vector<T>::destroy(T* first, int count)
+{
+    if constexpr (!is_trivially_destructible<T>::value) {
+        for (int i=0; i < count; i++)
+            first[i].~T();
+    }
+}
+
+template <typename T>
+void Vector<T>::moveElements(T* from, int count, T* to)
+{
+    if constexpr (RELOCATABLE) {
+        if (count > 0)
+            std::memcpy(static_cast<void*>(to), from, sizeof(T) * static_cast<size_t>(count));
+        return;
+    }
+    int i = 0;
+    try {
+        for (; i < count; i++)
+            new (to + i) T(std::move_if_noexcept(from[i]));
+    } catch (...) {
+        destroy(to, i);
+        throw;
+    }
+}
+
+// Новая ёмкость: не меньше запрошенной и не меньше удвоенной
+template <typename T>
+int Vector<T>::grownCapacity(int newCapacity) const
+{
+    return newCapacity < capacity*2 ?
+           capacity*2 : newCapacity;
+}
+
+// Уничтожает элементы и освобождает память
+template <typename T>
+void Vector<T>::release()
+{
+    destroy(ptr, size);
+    deallocate(ptr);
+    ptr = nullptr;
+    size = 0;
+    capacity = 0;
+}
+
+
+// С заданным размером
+template <typename T>
+Vector<T>::Vector(int startCapacity)
+{
+    if (startCapacity <= 0 or startCapacity >= maxSize)
+        capacity = DEFAULT_CAPACITY;
+    else
+        capacity = startCapacity;
+    ptr = allocate(capacity);
+    size = 0;
+}
+
+
+// С заданным размером и наполнением
+template <typename T>
+Vector<T>::Vector(int initialSize, const T& initialValue)
+{
+    if (initialSize <= 0)
+        capacity = DEFAULT_CAPACITY;
+    else
+        capacity = initialSize;
+
+    ptr = allocate(capacity);
+    size = 0;
+    try {
+        for (; size < initialSize; size++)
+            new (ptr + size) T(initialValue);
+    } catch (...) {
+        release();
+        throw;
+    }
+}
+
+// Деструктор
+template <typename T>
+Vector<T>::~Vector() {
+    release();
+}
+
+// Копирование
+template <typename T>
+Vector<T>::Vector(const Vector &arr){
+    ptr = allocate(arr.capacity);
+    size = 0;
+    capacity = arr.capacity;
+    if constexpr (RELOCATABLE) {
+        moveElements(arr.ptr, arr.size, ptr);
+        size = arr.size;
+        return;
+    }
+    try {
+        for (; size < arr.size; size++)
+            new (ptr + size) T(arr.ptr[size]);
+    } catch (...) {
+        release();
+        throw;
+    }
+}
+
+// Перемещение: забираем память, arr остаётся пустым
+template <typename T>
+Vector<T>::Vector(Vector &&arr) noexcept : ptr(arr.ptr), size(arr.size), capacity(arr.capacity)
+{
+    arr.ptr = nullptr;
+    arr.size = 0;
+    arr.capacity = 0;
+}
+
+
+// Присваивание (через копию, чтобы при исключении *this не изменился)
+template <typename T>
+Vector<T>& Vector<T>::operator =(const Vector& arr)
+{
+    if (this == &arr)
+        return *this;
+
+    Vector copy(arr);
+    swap(copy);
+    return *this;
+}
+
+template <typename T>
+Vector<T>& Vector<T>::operator =(Vector&& arr) noexcept
+{
+    if (this == &arr)
+        return *this;
+
+    release();
+    swap(arr);
+    return *this;
+}
+
+
+// Операторы сравнения
+template <typename T>
+bool Vector<T>::operator ==(const Vector& other) const {
+    if (size != other.size) {
+        return false;
+    }
+
+    for (int i = 0; i < size; ++i) {
+        if (ptr[i] != other.ptr[i]) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+template <typename T>
+bool Vector<T>::operator !=(const Vector& other) const {
+    return !(*this == other);
+}
+
+
+template <typename T>
+T& Vector<T>::operator [](int index)
+{
+    if (index >= size || index < 0)
+        throw ArrayException();
+    else
+        return ptr[index];
+}
+
+template <typename T>
+const T& Vector<T>::operator [](int index) const
+{
+    if (index >= size || index < 0)
+        throw ArrayException();
+    else
+        return ptr[index];
+}
+
+
+
+
+
+template <typename T>
+int Vector<T>::getSize() const {
+    return size;
+}
+template <typename T>
+int Vector<T>::getCapacity() const {
+    return capacity;
+}
+
+
+
+template <typename T>
+bool Vector<T>::isEmpty() const {
+    if (size == 0)
+        return true;
+    else
+        return false;
+}
+
+template <typename T>
+void Vector<T>::clear(){
+    if (!isEmpty()){
+        release();
+    }
+}
+
+template <typename T>
+void Vector<T>::swap(Vector& other) noexcept {
+    std::swap(ptr, other.ptr);
+    std::swap(size, other.size);
+    std::swap(capacity, other.capacity);
+}
+
+template <typename T>
+void Vector<T>::increaseCapacity(int newCapacity){
+    int grown = grownCapacity(newCapacity);
+    if constexpr (RELOCATABLE) {
+        // При неудаче realloc старый блок не трогает
+        void* memory = std::realloc(ptr, sizeof(T) * static_cast<size_t>(grown));
+        if (!memory)
+            throw std::bad_alloc();
+        ptr = static_cast<T*>(memory);
+        capacity = grown;
+        return;
+    }
+    T* newPtr = allocate(grown);
+    try {
+        moveElements(ptr, size, newPtr);
+    } catch (...) {
+        deallocate(newPtr);
+        throw;
+    }
+    destroy(ptr, size);
+    deallocate(ptr);
+    ptr = newPtr;
+    capacity = grown;
+}
+
+
+template <typename T>
+void Vector<T>::push_back(const T& element){
+    emplace_back(element);
+}
+
+template <typename T>
+void Vector<T>::push_back(T&& element){
+    emplace_back(std::move(element));
+}
+
+// Новый элемент создаётся раньше, чем переносятся старые, поэтому
+// аргументы могут ссылаться на элементы самого вектора.
+template <typename T>
+template <typename... Args>
+T& Vector<T>::emplace_back(Args&&... args){
+    if (size < capacity) {
+        new (ptr + size) T(std::forward<Args>(args)...);
+        size++;
+        return ptr[size-1];
+    }
+
+    if constexpr (RELOCATABLE) {
+        // Аргументы могут указывать в старый блок, который realloc освободит
+        T element(std::forward<Args>(args)...);
+        increaseCapacity(size+1);
+        new (ptr + size) T(std::move(element));
+        size++;
+        return ptr[size-1];
+    }
+
+    int grown = grownCapacity(size+1);
+    T* newPtr = allocate(grown);
+    try {
+        new (newPtr + size) T(std::forward<Args>(args)...);
+    } catch (...) {
+        deallocate(newPtr);
+        throw;
+    }
+    try {
+        moveElements(ptr, size, newPtr);
+    } catch (...) {
+        newPtr[size].~T();
+        deallocate(newPtr);
+        throw;
+    }
+    destroy(ptr, size);
+    deallocate(ptr);
+    ptr = newPtr;
+    capacity = grown;
+    size++;
+    return ptr[size-1];
+}
+
+template <typename T>
+void Vector<T>::pop_back(){
+    ptr[size-1].~T();
+    size--;
+}
+
+template <typename T>
+void Vector<T>::remove(int index){
+    if (index < 0 || index >= size)
+        throw ArrayException();
+    if constexpr (RELOCATABLE) {
+        std::memmove(static_cast<void*>(ptr + index), ptr + index + 1, sizeof(T) * static_cast<size_t>(size - index - 1));
+        size--;
+        return;
+    }
+    for (int j=index; j < size-1; j++)
+        ptr[j] = std::move(ptr[j+1]);
+    ptr[size-1].~T();
+    size--;
+}
+
+
+
+
+
+
+template <typename T>
+ostream& operator <<(ostream& out, const Vector<T>& v){
+    out << "Total size: "<< v.size << endl;
+    for (int i=0; i < v.size; i++)
+        out << v.ptr[i] << endl;
+    return out;
+}
+
+
 #endif //VECTOR_VECTOR_H
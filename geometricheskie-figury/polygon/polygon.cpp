@@ -1,4 +1,5 @@
 #include "polygon.h"
+#include <cmath>
 #pragma once
 
 double distance(const std::pair<double, double>& p1, const std::pair<double, double>& p2) {
@@ -7,7 +8,7 @@ double distance(const std::pair<double, double>& p1, const std::pair<double, dou
 
 double Polygon::calc_perimetr() {
     double perimeter = 0;
-    for (size_t i = 0; i < vertices.getSize(); ++i) {
+    for (int i = 0; i < vertices.getSize(); ++i) {
         perimeter += distance(vertices[i], vertices[(i + 1) % vertices.getSize()]);
     }
     return perimeter;
@@ -16,7 +17,7 @@ double Polygon::calc_perimetr() {
 // Метод для вычисления площади многоугольника
 double Polygon::calc_area() {
     double area = 0;
-    for (size_t i = 0; i < vertices.getSize(); ++i) {
+    for (int i = 0; i < vertices.getSize(); ++i) {
         area += vertices[i].first * vertices[(i + 1) % vertices.getSize()].second -
                 vertices[(i + 1) % vertices.getSize()].first * vertices[i].second;
     }
@@ -33,3 +34,5 @@ void Polygon::addVertex(const std::pair<double, double>& vertex) {
 }
 
 Polygon::Polygon(const Vector<std::pair<double, double>>& vertices) : vertices(vertices) {}
+
+Polygon::Polygon(Vector<std::pair<double, double>>&& vertices) : vertices(std::move(vertices)) {}
@@ -3,11 +3,13 @@
 
 #pragma once
 #include "../figure.h"
-#include "../../vector/vector.h"
+#include "../../Vector/Vector.h"
+#include <utility>
 
 class Polygon : public Geometric_Figure {
 public:
     Polygon(const Vector<std::pair<double, double>>& vertices);
+    Polygon(Vector<std::pair<double, double>>&& vertices);
     void addVertex(const std::pair<double, double>& vertex);
 
     double calc_perimetr() override;